@@ -0,0 +1,319 @@
+//External includes
+#include <benchmark/benchmark.h>
+
+//Standard includes
+#include <filesystem>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Project includes
+#include "DataTypes.h"
+#include "Maths.h"
+#include "Texture.h"
+#include "Utils.h"
+
+using namespace dae;
+
+namespace
+{
+	//Inputs are cycled through, so every iteration works on data the compiler cannot fold
+	constexpr size_t INPUT_COUNT = 1024;
+
+	std::vector<Matrix> CreateMatrices(std::mt19937& generator)
+	{
+		std::uniform_real_distribution<float> angle{ -PI, PI };
+		std::uniform_real_distribution<float> offset{ -50.f, 50.f };
+
+		std::vector<Matrix> matrices{};
+		for (size_t index = 0; index < INPUT_COUNT; ++index)
+		{
+			matrices.push_back(
+				Matrix::CreateRotation(angle(generator), angle(generator), angle(generator)) *
+				Matrix::CreateTranslation(offset(generator), offset(generator), offset(generator)));
+		}
+
+		return matrices;
+	}
+
+	std::vector<Vector3> CreateVectors(std::mt19937& generator)
+	{
+		std::uniform_real_distribution<float> coordinate{ -50.f, 50.f };
+
+		std::vector<Vector3> vectors{};
+		for (size_t index = 0; index < INPUT_COUNT; ++index)
+		{
+			vectors.push_back({ coordinate(generator), coordinate(generator), coordinate(generator) });
+		}
+
+		return vectors;
+	}
+
+	std::vector<Vector2> CreateUVs(std::mt19937& generator)
+	{
+		std::uniform_real_distribution<float> coordinate{ 0.f, 1.f };
+
+		std::vector<Vector2> uvs{};
+		for (size_t index = 0; index < INPUT_COUNT; ++index)
+		{
+			uvs.push_back({ coordinate(generator), coordinate(generator) });
+		}
+
+		return uvs;
+	}
+
+	constexpr int FRAME_WIDTH = 1920;
+	constexpr int FRAME_HEIGHT = 1080;
+
+	//The texture is turned 60 degrees on screen
+	const Vector2 ROTATED_AXIS_X{ std::cos(PI / 3.f), std::sin(PI / 3.f) };
+	const Vector2 ROTATED_AXIS_Y{ -ROTATED_AXIS_X.y, ROTATED_AXIS_X.x };
+
+	//UV of a pixel in a 1920x1080 frame rasterized in 64x64 tiles, like the renderer does,
+	//with the texture repeated repeats times over the frame height and rotated, so neighbouring pixels do not walk along texel rows
+	Vector2 GetRotatedFrameUV(uint64_t index, float repeats)
+	{
+		constexpr int TILE_SIZE = 64;
+		constexpr int TILES_PER_ROW = (FRAME_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+		constexpr int TILES_PER_COLUMN = (FRAME_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+
+		const int tile = static_cast<int>((index / (TILE_SIZE * TILE_SIZE)) % (TILES_PER_ROW * TILES_PER_COLUMN));
+		const int pixel = static_cast<int>(index % (TILE_SIZE * TILE_SIZE));
+		const float x = static_cast<float>((tile % TILES_PER_ROW) * TILE_SIZE + pixel % TILE_SIZE) - FRAME_WIDTH / 2.f;
+		const float y = static_cast<float>((tile / TILES_PER_ROW) * TILE_SIZE + pixel / TILE_SIZE) - FRAME_HEIGHT / 2.f;
+
+		const float scale = repeats / FRAME_HEIGHT;
+		const float u = (x * ROTATED_AXIS_X.x + y * ROTATED_AXIS_Y.x) * scale + 0.5f;
+		const float v = (x * ROTATED_AXIS_X.y + y * ROTATED_AXIS_Y.y) * scale + 0.5f;
+
+		//Wrap into [0, 1)
+		return { u - std::floor(u), v - std::floor(v) };
+	}
+}
+
+//Benchmarks [--resources=<directory>] [Google Benchmark flags: --benchmark_filter=<regex> --benchmark_out=<file.json> ...]
+int main(int argc, char* argv[])
+{
+	//--resources is taken out first, Google Benchmark rejects arguments it does not know
+	std::string resources{ "Resources" };
+	const char* const resourcesOption{ "--resources=" };
+	int argumentCount{ 1 };
+	for (int index{ 1 }; index < argc; ++index)
+	{
+		if (std::strncmp(argv[index], resourcesOption, std::strlen(resourcesOption)) == 0)
+			resources = argv[index] + std::strlen(resourcesOption);
+		else
+			argv[argumentCount++] = argv[index];
+	}
+	argc = argumentCount;
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+
+	if (!std::filesystem::exists(resources + "/vehicle.obj"))
+	{
+		std::cout << "Could not find the Rasterizer resources in " << resources << ", pass --resources=<directory>" << std::endl;
+		return 1;
+	}
+
+	std::mt19937 generator{ 0 };
+	const std::vector<Matrix> matrices{ CreateMatrices(generator) };
+	const std::vector<Matrix> otherMatrices{ CreateMatrices(generator) };
+	const std::vector<Vector3> vectors{ CreateVectors(generator) };
+	const std::vector<Vector3> otherVectors{ CreateVectors(generator) };
+	const std::vector<Vector2> uvs{ CreateUVs(generator) };
+
+	std::vector<Vector4> points{};
+	for (const Vector3& vector : vectors)
+	{
+		points.push_back({ vector, 1.f });
+	}
+
+	//Math
+	benchmark::RegisterBenchmark("Matrix::operator*", [&](benchmark::State& state)
+		{
+			for (size_t index = 0; state.KeepRunning(); ++index)
+			{
+				benchmark::DoNotOptimize(matrices[index % INPUT_COUNT] * otherMatrices[index % INPUT_COUNT]);
+			}
+		});
+
+	benchmark::RegisterBenchmark("Matrix::TransformPoint/Vector3", [&](benchmark::State& state)
+		{
+			for (size_t index = 0; state.KeepRunning(); ++index)
+			{
+				benchmark::DoNotOptimize(matrices[index % INPUT_COUNT].TransformPoint(vectors[index % INPUT_COUNT]));
+			}
+		});
+
+	benchmark::RegisterBenchmark("Matrix::TransformPoint/Vector4", [&](benchmark::State& state)
+		{
+			for (size_t index = 0; state.KeepRunning(); ++index)
+			{
+				benchmark::DoNotOptimize(matrices[index % INPUT_COUNT].TransformPoint(points[index % INPUT_COUNT]));
+			}
+		});
+
+	benchmark::RegisterBenchmark("Matrix::Inverse", [&](benchmark::State& state)
+		{
+			for (size_t index = 0; state.KeepRunning(); ++index)
+			{
+				benchmark::DoNotOptimize(Matrix::Inverse(matrices[index % INPUT_COUNT]));
+			}
+		});
+
+	benchmark::RegisterBenchmark("Vector3::Normalize", [&](benchmark::State& state)
+		{
+			for (size_t index = 0; state.KeepRunning(); ++index)
+			{
+				Vector3 vector{ vectors[index % INPUT_COUNT] };
+				benchmark::DoNotOptimize(vector.Normalize());
+				benchmark::DoNotOptimize(vector);
+			}
+		});
+
+	benchmark::RegisterBenchmark("Vector3::Cross", [&](benchmark::State& state)
+		{
+			for (size_t index = 0; state.KeepRunning(); ++index)
+			{
+				benchmark::DoNotOptimize(Vector3::Cross(vectors[index % INPUT_COUNT], otherVectors[index % INPUT_COUNT]));
+			}
+		});
+
+	benchmark::RegisterBenchmark("Vector3::Dot", [&](benchmark::State& state)
+		{
+			for (size_t index = 0; state.KeepRunning(); ++index)
+			{
+				benchmark::DoNotOptimize(Vector3::Dot(vectors[index % INPUT_COUNT], otherVectors[index % INPUT_COUNT]));
+			}
+		});
+
+	//Texture, once for every texel layout
+	const std::pair<Texture::Layout, std::string> layouts[]
+	{
+		{ Texture::Layout::linear, "linear" },
+		{ Texture::Layout::tiled, "tiled" },
+		{ Texture::Layout::morton, "morton" }
+	};
+
+	std::vector<Texture*> textures{};
+	for (const auto& [layout, layoutName] : layouts)
+	{
+		Texture* pTexture{ Texture::LoadFromFile(resources + "/vehicle_diffuse.png", layout) };
+		if (!pTexture)
+		{
+			for (const Texture* pLoadedTexture : textures)
+			{
+				delete pLoadedTexture;
+			}
+			return 1;
+		}
+		textures.push_back(pTexture);
+
+		benchmark::RegisterBenchmark(("Texture::Sample/" + layoutName + "/random").c_str(), [&uvs, pTexture](benchmark::State& state)
+			{
+				for (size_t index = 0; state.KeepRunning(); ++index)
+				{
+					benchmark::DoNotOptimize(pTexture->Sample(uvs[index % INPUT_COUNT]));
+				}
+			});
+
+		benchmark::RegisterBenchmark(("Texture::Sample/" + layoutName + "/rotated_1080p").c_str(), [pTexture](benchmark::State& state)
+			{
+				for (uint64_t index = 0; state.KeepRunning(); ++index)
+				{
+					benchmark::DoNotOptimize(pTexture->Sample(GetRotatedFrameUV(index, 1.f)));
+				}
+			});
+	}
+
+	//Texture filters on a minified texture, it repeats 8 times over the frame height so every pixel step covers about 4 texels
+	const std::pair<Texture::Filter, std::string> filters[]
+	{
+		{ Texture::Filter::point, "point" },
+		{ Texture::Filter::bilinear, "bilinear" },
+		{ Texture::Filter::nearestMip, "nearest_mip" },
+		{ Texture::Filter::trilinear, "trilinear" }
+	};
+
+	constexpr float minifiedRepeats = 8.f;
+	const Vector2 minifiedDerivativeX{ ROTATED_AXIS_X * (minifiedRepeats / FRAME_HEIGHT) };
+	const Vector2 minifiedDerivativeY{ ROTATED_AXIS_Y * (minifiedRepeats / FRAME_HEIGHT) };
+
+	for (const auto& [filter, filterName] : filters)
+	{
+		const Texture* pTexture{ textures.front() };
+		benchmark::RegisterBenchmark(("Texture::Sample/" + filterName + "/minified").c_str(), [=](benchmark::State& state)
+			{
+				for (uint64_t index = 0; state.KeepRunning(); ++index)
+				{
+					benchmark::DoNotOptimize(pTexture->Sample(GetRotatedFrameUV(index, minifiedRepeats), minifiedDerivativeX, minifiedDerivativeY, filter));
+				}
+			});
+	}
+
+	//Bilinear filtering of the same minified uvs, one sample per call against a batch of 64 per call
+	constexpr int BATCH_SIZE = 64;
+	std::vector<float> batchU{};
+	std::vector<float> batchV{};
+	for (uint64_t index = 0; index < INPUT_COUNT; ++index)
+	{
+		const Vector2 uv{ GetRotatedFrameUV(index, minifiedRepeats) };
+		batchU.push_back(uv.x);
+		batchV.push_back(uv.y);
+	}
+
+	benchmark::RegisterBenchmark("Texture::Sample/bilinear/single_x64", [&, pTexture = textures.front()](benchmark::State& state)
+		{
+			ColorRGB colors[BATCH_SIZE]{};
+			for (size_t batch = 0; state.KeepRunning(); batch = (batch + BATCH_SIZE) % INPUT_COUNT)
+			{
+				for (int index = 0; index < BATCH_SIZE; ++index)
+				{
+					colors[index] = pTexture->Sample({ batchU[batch + index], batchV[batch + index] }, {}, {}, Texture::Filter::bilinear);
+				}
+				benchmark::DoNotOptimize(colors);
+			}
+		});
+
+	benchmark::RegisterBenchmark("Texture::SampleBilinear/batched_x64", [&, pTexture = textures.front()](benchmark::State& state)
+		{
+			ColorRGB colors[BATCH_SIZE]{};
+			for (size_t batch = 0; state.KeepRunning(); batch = (batch + BATCH_SIZE) % INPUT_COUNT)
+			{
+				pTexture->SampleBilinear(batchU.data() + batch, batchV.data() + batch, BATCH_SIZE, colors);
+				benchmark::DoNotOptimize(colors);
+			}
+		});
+
+	//Mesh loading, every iteration parses the whole file
+	for (const char* model : { "vehicle.obj", "tuktuk.obj" })
+	{
+		const std::string path{ resources + "/" + model };
+		benchmark::RegisterBenchmark((std::string{ "Utils::ParseOBJ/" } + model).c_str(), [path](benchmark::State& state)
+			{
+				while (state.KeepRunning())
+				{
+					std::vector<Vertex> vertices{};
+					std::vector<uint32_t> indices{};
+					benchmark::DoNotOptimize(Utils::ParseOBJ(path, vertices, indices));
+					benchmark::DoNotOptimize(vertices.data());
+				}
+			});
+	}
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+
+	for (const Texture* pTexture : textures)
+	{
+		delete pTexture;
+	}
+
+	return 0;
+}
@@ -154,7 +154,7 @@ namespace dae
 			//checks for angle change
 			if (std::abs(initFov - fovAngle) >= 0.00001f)
 			{
-				fov = std::atanf(fovAngle);
+				fov = std::atan(fovAngle);
 			}
 
 			//Update Matrices
@@ -22,6 +22,122 @@ namespace dae
 		Vector3 normal{};
 		Vector3 tangent{};
 		Vector3 viewDirection{};
+
+		//Change of the uv to the next pixel on the right and below, only set for filters that pick a mip level
+		Vector2 uvDerivativeX{};
+		Vector2 uvDerivativeY{};
+	};
+
+	//Post-transform attributes a frame actually reads, the others are never written
+	struct VertexAttributes
+	{
+		bool uv{ true };
+		bool normal{ true };
+		bool tangent{ true };
+		bool viewDirection{ true };
+	};
+
+	//Post-transform vertices stored as one contiguous stream per component
+	struct VertexStreams
+	{
+		//Screen x and y, NDC z and 1 / w
+		std::vector<float> positionX{};
+		std::vector<float> positionY{};
+		std::vector<float> positionZ{};
+		std::vector<float> positionW{};
+
+		std::vector<float> u{};
+		std::vector<float> v{};
+
+		std::vector<float> normalX{};
+		std::vector<float> normalY{};
+		std::vector<float> normalZ{};
+
+		std::vector<float> tangentX{};
+		std::vector<float> tangentY{};
+		std::vector<float> tangentZ{};
+
+		std::vector<float> viewDirectionX{};
+		std::vector<float> viewDirectionY{};
+		std::vector<float> viewDirectionZ{};
+
+		VertexAttributes attributes{};
+
+		size_t Size() const
+		{
+			return positionX.size();
+		}
+
+		//All streams keep the same size, so indices of appended (clipped) vertices stay valid in every stream
+		void Resize(size_t size)
+		{
+			for (std::vector<float>* pStream :
+				{
+					&positionX, &positionY, &positionZ, &positionW,
+					&u, &v,
+					&normalX, &normalY, &normalZ,
+					&tangentX, &tangentY, &tangentZ,
+					&viewDirectionX, &viewDirectionY, &viewDirectionZ
+				})
+			{
+				pStream->resize(size);
+			}
+		}
+
+		Vector4 GetPosition(uint32_t index) const
+		{
+			return { positionX[index], positionY[index], positionZ[index], positionW[index] };
+		}
+
+		void Store(uint32_t index, const Vertex_Out& vertex)
+		{
+			positionX[index] = vertex.position.x;
+			positionY[index] = vertex.position.y;
+			positionZ[index] = vertex.position.z;
+			positionW[index] = vertex.position.w;
+
+			if (attributes.uv)
+			{
+				u[index] = vertex.uv.x;
+				v[index] = vertex.uv.y;
+			}
+			if (attributes.normal)
+			{
+				normalX[index] = vertex.normal.x;
+				normalY[index] = vertex.normal.y;
+				normalZ[index] = vertex.normal.z;
+			}
+			if (attributes.tangent)
+			{
+				tangentX[index] = vertex.tangent.x;
+				tangentY[index] = vertex.tangent.y;
+				tangentZ[index] = vertex.tangent.z;
+			}
+			if (attributes.viewDirection)
+			{
+				viewDirectionX[index] = vertex.viewDirection.x;
+				viewDirectionY[index] = vertex.viewDirection.y;
+				viewDirectionZ[index] = vertex.viewDirection.z;
+			}
+		}
+
+		uint32_t PushBack(const Vertex_Out& vertex)
+		{
+			const uint32_t index{ static_cast<uint32_t>(Size()) };
+			Resize(index + size_t{ 1 });
+			Store(index, vertex);
+
+			return index;
+		}
+
+		//Perspective correct sum of the three weighted values, still to be multiplied by the pixel depth
+		float Interpolate(const std::vector<float>& stream, uint32_t vertex0, uint32_t vertex1, uint32_t vertex2, float weightV0, float weightV1, float weightV2) const
+		{
+			return
+				((stream[vertex0] * weightV0) * positionW[vertex0]) +
+				((stream[vertex1] * weightV1) * positionW[vertex1]) +
+				((stream[vertex2] * weightV2) * positionW[vertex2]);
+		}
 	};
 
 	enum class PrimitiveTopology
@@ -30,13 +146,95 @@ namespace dae
 		TriangleStrip
 	};
 
+	struct MeshBounds
+	{
+		//Axis aligned bounding box in object space
+		Vector3 minimum{};
+		Vector3 maximum{};
+
+		//Bounding sphere in object space
+		Vector3 center{};
+		float radius{};
+	};
+
 	struct Mesh
 	{
 		std::vector<Vertex> vertices{};
 		std::vector<uint32_t> indices{};
 		PrimitiveTopology primitiveTopology{ PrimitiveTopology::TriangleStrip };
+		MeshBounds bounds{};
 
-		std::vector<Vertex_Out> vertices_out{};
+		VertexStreams vertices_out{};
 		Matrix worldMatrix{};
+
+		//False when the bounds were outside the view frustum this frame
+		bool isVisible{ true };
+	};
+
+	struct TriangleBoundingBox
+	{
+		//Pixel range [min, max[
+		int minX{};
+		int minY{};
+		int maxX{};
+		int maxY{};
+	};
+
+	//Edge function a * x + b * y + c of the edge from v0 to v1, scaled by the inverse of twice the triangle area
+	struct EdgeFunction
+	{
+		float a{};
+		float b{};
+		float c{};
+
+		static EdgeFunction Create(const Vector2& v0, const Vector2& v1, float inverseDoubleArea)
+		{
+			const float a{ (v0.y - v1.y) * inverseDoubleArea };
+			const float b{ (v1.x - v0.x) * inverseDoubleArea };
+
+			return { a, b, -((a * v0.x) + (b * v0.y)) };
+		}
+
+		float Evaluate(const Vector2& pixel) const
+		{
+			return (a * pixel.x) + (b * pixel.y) + c;
+		}
+	};
+
+	struct Triangle
+	{
+		uint32_t meshIndex{};
+		uint32_t vertex0{};
+		uint32_t vertex1{};
+		uint32_t vertex2{};
+
+		//Twice the signed screen space area, positive for clockwise (front facing) triangles
+		float doubleArea{};
+
+		TriangleBoundingBox boundingBox{};
+
+		//Edge i gives the barycentric weight of vertex i
+		EdgeFunction edgeFunctions[3]{};
+
+		//Nearest depth of the triangle, used to reject it against the hierarchical depth buffer
+		float minDepth{};
+	};
+
+	struct Tile
+	{
+		TriangleBoundingBox boundingBox{};
+
+		//Indices into the triangles of the current frame, in submission order
+		std::vector<uint32_t> triangleIndices{};
+
+		//Farthest depth currently in the tile
+		float maxDepth{ INFINITY };
+
+		//Raster counters of the current frame, every tile counts on its own so workers share nothing
+		uint32_t trianglesCulledHiZ{};
+		uint32_t trianglesRasterized{};
+		uint32_t pixelsTested{};
+		uint32_t pixelsPassedDepth{};
+		uint32_t pixelsShaded{};
 	};
 }
@@ -0,0 +1,147 @@
+#include "Profiler.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace dae;
+
+namespace
+{
+	struct ZoneEvent
+	{
+		const char* pName = nullptr;
+		uint64_t start = 0;
+		uint64_t end = 0;
+		uint32_t frame = 0;
+	};
+
+	//Oldest zones are overwritten once a thread records more than this during one capture
+	constexpr uint64_t RING_SIZE = 1 << 16;
+
+	//Only its own thread writes, the capture is read after the last frame ended
+	struct ThreadRing
+	{
+		uint32_t threadId = 0;
+		std::atomic<uint64_t> writeCount{ 0 };
+		std::vector<ZoneEvent> events = std::vector<ZoneEvent>(RING_SIZE);
+	};
+
+	//Only locked when a thread records its first zone and when a capture starts or is written
+	std::mutex g_RingsMutex{};
+	std::vector<std::unique_ptr<ThreadRing>> g_Rings{};
+
+	thread_local ThreadRing* t_pRing = nullptr;
+
+	std::atomic<uint32_t> g_CaptureFrame{ 0 };
+	uint32_t g_CaptureFrameCount = 0;
+	uint64_t g_CaptureStart = 0;
+	std::string g_CapturePath{};
+
+	ThreadRing& GetThreadRing()
+	{
+		if (!t_pRing)
+		{
+			const std::lock_guard<std::mutex> lock(g_RingsMutex);
+			g_Rings.push_back(std::make_unique<ThreadRing>());
+			g_Rings.back()->threadId = static_cast<uint32_t>(g_Rings.size());
+			t_pRing = g_Rings.back().get();
+		}
+
+		return *t_pRing;
+	}
+}
+
+void Profiler::BeginCapture(uint32_t frameCount, const std::string& path)
+{
+	if (frameCount == 0 || IsCapturing())
+		return;
+
+#ifdef PROFILE_ZONES
+	{
+		const std::lock_guard<std::mutex> lock(g_RingsMutex);
+		for (const auto& pRing : g_Rings)
+		{
+			pRing->writeCount.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	g_CaptureFrame.store(0, std::memory_order_relaxed);
+	g_CaptureFrameCount = frameCount;
+	g_CaptureStart = GetTimestamp();
+	g_CapturePath = path;
+
+	s_IsCapturing.store(true, std::memory_order_release);
+#else
+	std::cout << "Profile zones are compiled out, define PROFILE_ZONES in Profiler.h to capture " << path << std::endl;
+#endif
+}
+
+void Profiler::EndFrame()
+{
+	if (!IsCapturing())
+		return;
+
+	const uint32_t frame = g_CaptureFrame.fetch_add(1, std::memory_order_relaxed) + 1;
+	if (frame < g_CaptureFrameCount)
+		return;
+
+	s_IsCapturing.store(false, std::memory_order_release);
+	WriteCapture();
+}
+
+uint64_t Profiler::GetTimestamp()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::Record(const char* pName, uint64_t start, uint64_t end)
+{
+	ThreadRing& ring = GetThreadRing();
+
+	const uint64_t writeCount = ring.writeCount.load(std::memory_order_relaxed);
+	ring.events[writeCount % RING_SIZE] = { pName, start, end, g_CaptureFrame.load(std::memory_order_relaxed) };
+	ring.writeCount.store(writeCount + 1, std::memory_order_release);
+}
+
+void Profiler::WriteCapture()
+{
+	std::ofstream file(g_CapturePath);
+	if (!file)
+	{
+		std::cout << "Something went wrong. Profile capture " << g_CapturePath << " not saved!" << std::endl;
+		return;
+	}
+
+	//Complete events ("ph": "X"), timestamps in microseconds since the capture started
+	file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+	bool isFirstEvent = true;
+	const std::lock_guard<std::mutex> lock(g_RingsMutex);
+	for (const auto& pRing : g_Rings)
+	{
+		const uint64_t writeCount = pRing->writeCount.load(std::memory_order_acquire);
+		const uint64_t firstEvent = (writeCount > RING_SIZE) ? writeCount - RING_SIZE : 0;
+
+		for (uint64_t index = firstEvent; index < writeCount; ++index)
+		{
+			const ZoneEvent& event = pRing->events[index % RING_SIZE];
+			if (event.start < g_CaptureStart)
+				continue;
+
+			file << (isFirstEvent ? "" : ",\n")
+				<< "{\"name\": \"" << event.pName << "\", \"ph\": \"X\""
+				<< ", \"ts\": " << static_cast<double>(event.start - g_CaptureStart) / 1000.0
+				<< ", \"dur\": " << static_cast<double>(event.end - event.start) / 1000.0
+				<< ", \"pid\": 0, \"tid\": " << pRing->threadId
+				<< ", \"args\": {\"frame\": " << event.frame << "}}";
+			isFirstEvent = false;
+		}
+	}
+
+	file << "\n]}\n";
+	std::cout << "Profile capture of " << g_CaptureFrameCount << " frames saved to " << g_CapturePath << std::endl;
+}
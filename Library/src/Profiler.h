@@ -0,0 +1,71 @@
+#pragma once
+
+//Standard includes
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+//Comment out to compile every PROFILE_ZONE away, a build without zones has no profiling overhead at all
+#define PROFILE_ZONES
+
+namespace dae
+{
+	//Scoped timing zones, every thread records into its own ring buffer without locking
+	//A capture covers a range of frames and is written as a chrome://tracing / Perfetto JSON file
+	class Profiler final
+	{
+	public:
+		Profiler() = delete;
+
+		//Records the next frameCount frames and writes them to path once the last one ends
+		static void BeginCapture(uint32_t frameCount, const std::string& path);
+		static void EndFrame();
+
+		static bool IsCapturing() { return s_IsCapturing.load(std::memory_order_relaxed); };
+
+		static uint64_t GetTimestamp();
+		static void Record(const char* pName, uint64_t start, uint64_t end);
+
+	private:
+		static inline std::atomic<bool> s_IsCapturing{ false };
+
+		static void WriteCapture();
+	};
+
+	//Times the enclosing scope, when no capture is running that is one branch on entry and one on exit
+	class ProfileZone final
+	{
+	public:
+		explicit ProfileZone(const char* pName)
+		{
+			if (Profiler::IsCapturing())
+			{
+				m_pName = pName;
+				m_Start = Profiler::GetTimestamp();
+			}
+		}
+
+		~ProfileZone()
+		{
+			if (m_pName)
+				Profiler::Record(m_pName, m_Start, Profiler::GetTimestamp());
+		}
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone(ProfileZone&&) noexcept = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+		ProfileZone& operator=(ProfileZone&&) noexcept = delete;
+
+	private:
+		const char* m_pName = nullptr;
+		uint64_t m_Start = 0;
+	};
+}
+
+#define PROFILE_ZONE_CONCATENATE_IMPL(a, b) a##b
+#define PROFILE_ZONE_CONCATENATE(a, b) PROFILE_ZONE_CONCATENATE_IMPL(a, b)
+#ifdef PROFILE_ZONES
+#define PROFILE_ZONE(name) const dae::ProfileZone PROFILE_ZONE_CONCATENATE(profileZone, __LINE__){ name }
+#else
+#define PROFILE_ZONE(name)
+#endif
@@ -2,47 +2,479 @@
 #include "Vector2.h"
 #include <SDL_image.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace dae
 {
-	Texture::Texture(SDL_Surface* pSurface) :
-		m_pSurface{ pSurface },
-		m_pSurfacePixels{ (uint32_t*)pSurface->pixels }
+	namespace
+	{
+		//Channel byte to [0, 1], the same values a division by 255 gives
+		constexpr std::array<float, 256> CreateChannelTable()
+		{
+			std::array<float, 256> table{};
+			for (int value{}; value < 256; ++value)
+			{
+				table[value] = static_cast<float>(value) / 255.f;
+			}
+			return table;
+		}
+
+		constexpr std::array<float, 256> CHANNEL_TO_FLOAT{ CreateChannelTable() };
+
+		//Side of the 4x4 blocks of the tiled layout
+		constexpr uint32_t TILE_SIZE{ 4 };
+
+		uint32_t RoundUpToPowerOfTwo(uint32_t value)
+		{
+			uint32_t powerOfTwo{ 1 };
+			while (powerOfTwo < value)
+			{
+				powerOfTwo <<= 1;
+			}
+			return powerOfTwo;
+		}
+
+		//Puts a zero bit between every bit of value, the x and y of a Z-order index are interleaved this way
+		uint32_t SpreadBits(uint32_t value)
+		{
+			value &= 0x0000FFFF;
+			value = (value | (value << 8)) & 0x00FF00FF;
+			value = (value | (value << 4)) & 0x0F0F0F0F;
+			value = (value | (value << 2)) & 0x33333333;
+			value = (value | (value << 1)) & 0x55555555;
+			return value;
+		}
+
+		ColorRGB UnpackTexel(uint32_t texel)
+		{
+			return
+			{
+				CHANNEL_TO_FLOAT[texel & 0xFF],
+				CHANNEL_TO_FLOAT[(texel >> 8) & 0xFF],
+				CHANNEL_TO_FLOAT[(texel >> 16) & 0xFF]
+			};
+		}
+
+		//Box filter, every texel of the next level averages 2x2 texels
+		//An odd size rounds down, so its last row or column is dropped, a side of 1 reads its only texel twice
+		std::vector<uint32_t> Downsample(const std::vector<uint32_t>& texels, int width, int height)
+		{
+			const int nextWidth{ std::max(width / 2, 1) };
+			const int nextHeight{ std::max(height / 2, 1) };
+
+			std::vector<uint32_t> nextTexels(static_cast<size_t>(nextWidth) * nextHeight);
+			for (int y{}; y < nextHeight; ++y)
+			{
+				const int y0{ std::min(2 * y, height - 1) };
+				const int y1{ std::min(2 * y + 1, height - 1) };
+
+				for (int x{}; x < nextWidth; ++x)
+				{
+					const int x0{ std::min(2 * x, width - 1) };
+					const int x1{ std::min(2 * x + 1, width - 1) };
+
+					const uint32_t quad[4]
+					{
+						texels[y0 * width + x0], texels[y0 * width + x1],
+						texels[y1 * width + x0], texels[y1 * width + x1]
+					};
+
+					uint32_t averaged{};
+					for (int shift{}; shift < 32; shift += 8)
+					{
+						uint32_t sum{ 2 };
+						for (const uint32_t texel : quad)
+						{
+							sum += (texel >> shift) & 0xFF;
+						}
+						averaged |= (sum / 4) << shift;
+					}
+
+					nextTexels[y * nextWidth + x] = averaged;
+				}
+			}
+
+			return nextTexels;
+		}
+
+		//a * (256 - weight) + b * weight, rounded, divided by 256, every value and weight fits in 16 bits
+		uint32_t LerpFixedPoint(uint32_t a, uint32_t b, uint32_t weight)
+		{
+			return (a * (256 - weight) + b * weight + 128) >> 8;
+		}
+
+#if defined(__AVX2__)
+		//LerpFixedPoint on sixteen 16 bit channels
+		__m256i LerpFixedPoint(__m256i a, __m256i b, __m256i weight)
+		{
+			const __m256i inverseWeight{ _mm256_sub_epi16(_mm256_set1_epi16(256), weight) };
+			const __m256i sum{ _mm256_add_epi16(_mm256_mullo_epi16(a, inverseWeight), _mm256_mullo_epi16(b, weight)) };
+			return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(128)), 8);
+		}
+
+		//Eight bilinear blends of packed texels at once, weights are in [0, 256] per 32 bit lane
+		__m256i BlendBilinear(__m256i topLeft, __m256i topRight, __m256i bottomLeft, __m256i bottomRight, __m256i weightX, __m256i weightY)
+		{
+			//Texels are widened to 16 bit channels, the low half of each 128 bit lane holds its first two texels
+			//Every weight is copied to the four channels of its texel to line up with them
+			const __m256i pairedWeightX{ _mm256_or_si256(weightX, _mm256_slli_epi32(weightX, 16)) };
+			const __m256i pairedWeightY{ _mm256_or_si256(weightY, _mm256_slli_epi32(weightY, 16)) };
+			const __m256i zero{ _mm256_setzero_si256() };
+
+			const auto blendHalf = [&](auto unpackTexels, __m256i channelWeightX, __m256i channelWeightY)
+				{
+					const __m256i top{ LerpFixedPoint(unpackTexels(topLeft, zero), unpackTexels(topRight, zero), channelWeightX) };
+					const __m256i bottom{ LerpFixedPoint(unpackTexels(bottomLeft, zero), unpackTexels(bottomRight, zero), channelWeightX) };
+					return LerpFixedPoint(top, bottom, channelWeightY);
+				};
+
+			const __m256i low
+			{
+				blendHalf([](__m256i texels, __m256i zero) { return _mm256_unpacklo_epi8(texels, zero); },
+					_mm256_unpacklo_epi32(pairedWeightX, pairedWeightX), _mm256_unpacklo_epi32(pairedWeightY, pairedWeightY))
+			};
+			const __m256i high
+			{
+				blendHalf([](__m256i texels, __m256i zero) { return _mm256_unpackhi_epi8(texels, zero); },
+					_mm256_unpackhi_epi32(pairedWeightX, pairedWeightX), _mm256_unpackhi_epi32(pairedWeightY, pairedWeightY))
+			};
+
+			//Back to packed texels in the original order
+			return _mm256_packus_epi16(low, high);
+		}
+#endif
+	}
+
+	Texture::Texture(SDL_Surface* pSurface, Layout layout) :
+		m_Width{ pSurface->w },
+		m_Height{ pSurface->h },
+		m_Layout{ layout }
 	{
-		m_Red = new Uint8();
-		m_Green = new Uint8();
-		m_Blue = new Uint8();
+		std::vector<uint32_t> texels(static_cast<size_t>(m_Width) * m_Height);
+		for (int y{}; y < m_Height; ++y)
+		{
+			const uint32_t* pRow{ reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pSurface->pixels) + y * pSurface->pitch) };
+			std::copy(pRow, pRow + m_Width, texels.begin() + static_cast<size_t>(y) * m_Width);
+		}
+
+		//Full mip chain, every level half the size of the one before down to 1x1
+		int width{ m_Width };
+		int height{ m_Height };
+		AddMipLevel(texels, width, height);
+		while (width > 1 || height > 1)
+		{
+			texels = Downsample(texels, width, height);
+			width = std::max(width / 2, 1);
+			height = std::max(height / 2, 1);
+			AddMipLevel(texels, width, height);
+		}
 	}
 
 	Texture::~Texture()
 	{
-		if (m_pSurface)
+		for (const MipLevel& level : m_MipLevels)
+		{
+			delete[] level.pTexels;
+			delete[] level.pOffsetsX;
+			delete[] level.pOffsetsY;
+		}
+	}
+
+	void Texture::AddMipLevel(const std::vector<uint32_t>& texels, int width, int height)
+	{
+		MipLevel level{};
+		level.width = width;
+		level.height = height;
+
+		const uint32_t texelCount{ InitializeOffsets(level) };
+
+		level.pTexels = new uint32_t[texelCount]{};
+		for (int y{}; y < height; ++y)
+		{
+			for (int x{}; x < width; ++x)
+			{
+				level.pTexels[level.pOffsetsY[y] + level.pOffsetsX[x]] = texels[y * width + x];
+			}
+		}
+
+		m_MipLevels.push_back(level);
+	}
+
+	uint32_t Texture::InitializeOffsets(MipLevel& level) const
+	{
+		const uint32_t width{ static_cast<uint32_t>(level.width) };
+		const uint32_t height{ static_cast<uint32_t>(level.height) };
+
+		level.pOffsetsX = new uint32_t[width + 1];
+		level.pOffsetsY = new uint32_t[height + 1];
+
+		uint32_t texelCount{};
+		switch (m_Layout)
+		{
+		case Layout::linear:
+		default:
+		{
+			for (uint32_t x{}; x < width; ++x)
+			{
+				level.pOffsetsX[x] = x;
+			}
+			for (uint32_t y{}; y < height; ++y)
+			{
+				level.pOffsetsY[y] = y * width;
+			}
+
+			texelCount = width * height;
+			break;
+		}
+		case Layout::tiled:
+		{
+			const uint32_t tilesPerRow{ (width + TILE_SIZE - 1) / TILE_SIZE };
+			const uint32_t tilesPerColumn{ (height + TILE_SIZE - 1) / TILE_SIZE };
+			const uint32_t texelsPerTile{ TILE_SIZE * TILE_SIZE };
+
+			for (uint32_t x{}; x < width; ++x)
+			{
+				level.pOffsetsX[x] = (x / TILE_SIZE) * texelsPerTile + x % TILE_SIZE;
+			}
+			for (uint32_t y{}; y < height; ++y)
+			{
+				level.pOffsetsY[y] = (y / TILE_SIZE) * tilesPerRow * texelsPerTile + (y % TILE_SIZE) * TILE_SIZE;
+			}
+
+			texelCount = tilesPerRow * tilesPerColumn * texelsPerTile;
+			break;
+		}
+		case Layout::morton:
+		{
+			//A rectangle is a row of Z-ordered squares along its longer side
+			const uint32_t paddedWidth{ RoundUpToPowerOfTwo(width) };
+			const uint32_t paddedHeight{ RoundUpToPowerOfTwo(height) };
+			const uint32_t squareSize{ std::min(paddedWidth, paddedHeight) };
+			const uint32_t squareMask{ squareSize - 1 };
+			const uint32_t texelsPerSquare{ squareSize * squareSize };
+
+			for (uint32_t x{}; x < width; ++x)
+			{
+				level.pOffsetsX[x] = SpreadBits(x & squareMask) + (x / squareSize) * texelsPerSquare;
+			}
+			for (uint32_t y{}; y < height; ++y)
+			{
+				level.pOffsetsY[y] = (SpreadBits(y & squareMask) << 1) + (y / squareSize) * texelsPerSquare;
+			}
+
+			texelCount = paddedWidth * paddedHeight;
+			break;
+		}
+		}
+
+		level.pOffsetsX[width] = level.pOffsetsX[width - 1];
+		level.pOffsetsY[height] = level.pOffsetsY[height - 1];
+
+		return texelCount;
+	}
+
+	Texture* Texture::LoadFromFile(const std::string& path, Layout layout)
+	{
+		SDL_Surface* pSurface{ IMG_Load(path.c_str()) };
+		if (!pSurface)
+		{
+			std::cout << "Could not load texture " << path << ": " << IMG_GetError() << std::endl;
+			return nullptr;
+		}
+
+		//Whatever IMG_Load returned (24 bit, paletted, BGRA...) is converted to one packed layout,
+		//so sampling never has to go through the SDL_PixelFormat again
+		SDL_Surface* pConverted{ SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_ABGR8888, 0) };
+		SDL_FreeSurface(pSurface);
+		if (!pConverted)
 		{
-			SDL_FreeSurface(m_pSurface);
-			m_pSurface = nullptr;
+			std::cout << "Could not convert texture " << path << ": " << SDL_GetError() << std::endl;
+			return nullptr;
 		}
+
+		//The texture keeps its own texel copy, the surface is not needed after loading
+		Texture* pTexture{ new Texture(pConverted, layout) };
+		SDL_FreeSurface(pConverted);
+
+		return pTexture;
 	}
 
-	Texture* Texture::LoadFromFile(const std::string& path)
+	Texture* Texture::CreateFromColor(const ColorRGB& color, Layout layout)
 	{
-		//TODO
-		//Load SDL_Surface using IMG_LOAD
-		//Create & Return a new Texture Object (using SDL_Surface)
+		SDL_Surface* pSurface{ SDL_CreateRGBSurfaceWithFormat(0, 1, 1, 32, SDL_PIXELFORMAT_ABGR8888) };
+		if (!pSurface)
+		{
+			std::cout << "Could not create a 1x1 texture: " << SDL_GetError() << std::endl;
+			return nullptr;
+		}
 
-		return new Texture(IMG_Load(path.c_str()));
+		const auto toByte = [](float channel)
+			{
+				return static_cast<uint32_t>(std::clamp(channel, 0.f, 1.f) * 255.f + 0.5f);
+			};
+		*static_cast<uint32_t*>(pSurface->pixels) = toByte(color.r) | (toByte(color.g) << 8) | (toByte(color.b) << 16) | 0xFF000000;
+
+		Texture* pTexture{ new Texture(pSurface, layout) };
+		SDL_FreeSurface(pSurface);
+
+		return pTexture;
 	}
 
 	ColorRGB Texture::Sample(const Vector2& uv) const
 	{
-		//TODO
+		return SampleNearest(m_MipLevels.front(), uv);
+	}
+
+	ColorRGB Texture::Sample(const Vector2& uv, const Vector2& uvDerivativeX, const Vector2& uvDerivativeY, Filter filter) const
+	{
+		if (filter == Filter::point)
+			return SampleNearest(m_MipLevels.front(), uv);
+
+		if (filter == Filter::bilinear)
+			return UnpackTexel(FilterBilinear(m_MipLevels.front(), uv.x, uv.y));
+
+		const int lastLevel{ static_cast<int>(m_MipLevels.size()) - 1 };
+		const float levelOfDetail{ std::min(CalculateLevelOfDetail(uvDerivativeX, uvDerivativeY), static_cast<float>(lastLevel)) };
+
+		if (filter == Filter::nearestMip)
+			return SampleNearest(m_MipLevels[static_cast<int>(levelOfDetail + 0.5f)], uv);
+
+		//Trilinear, blend the two levels around the level of detail
+		const int level{ static_cast<int>(levelOfDetail) };
+		const float blend{ levelOfDetail - static_cast<float>(level) };
+
+		const ColorRGB sample{ UnpackTexel(FilterBilinear(m_MipLevels[level], uv.x, uv.y)) };
+		if (blend == 0.f)
+			return sample;
+
+		return sample * (1.f - blend) + UnpackTexel(FilterBilinear(m_MipLevels[level + 1], uv.x, uv.y)) * blend;
+	}
+
+	void Texture::SampleBilinear(const float* pU, const float* pV, int count, ColorRGB* pColors) const
+	{
+		const MipLevel& level{ m_MipLevels.front() };
+
+		int index{};
+#if defined(__AVX2__)
+		//Same steps as FilterBilinear, lane by lane
+		const __m256 width{ _mm256_set1_ps(static_cast<float>(level.width)) };
+		const __m256 height{ _mm256_set1_ps(static_cast<float>(level.height)) };
+		const __m256 half{ _mm256_set1_ps(0.5f) };
+		const __m256 fixedPointOne{ _mm256_set1_ps(256.f) };
+
+		const __m256i zero{ _mm256_setzero_si256() };
+		const __m256i one{ _mm256_set1_epi32(1) };
+		const __m256i lastX{ _mm256_set1_epi32(level.width - 1) };
+		const __m256i lastY{ _mm256_set1_epi32(level.height - 1) };
+
+		const int* pOffsetsX{ reinterpret_cast<const int*>(level.pOffsetsX) };
+		const int* pOffsetsY{ reinterpret_cast<const int*>(level.pOffsetsY) };
+		const int* pTexels{ reinterpret_cast<const int*>(level.pTexels) };
+
+		for (; index + 8 <= count; index += 8)
+		{
+			const __m256 x{ _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(pU + index), width), half) };
+			const __m256 y{ _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(pV + index), height), half) };
+			const __m256 floorX{ _mm256_floor_ps(x) };
+			const __m256 floorY{ _mm256_floor_ps(y) };
+
+			const __m256i weightX{ _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_sub_ps(x, floorX), fixedPointOne)) };
+			const __m256i weightY{ _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_sub_ps(y, floorY), fixedPointOne)) };
+
+			const __m256i cellX{ _mm256_cvttps_epi32(floorX) };
+			const __m256i cellY{ _mm256_cvttps_epi32(floorY) };
+			const __m256i x0{ _mm256_min_epi32(_mm256_max_epi32(cellX, zero), lastX) };
+			const __m256i y0{ _mm256_min_epi32(_mm256_max_epi32(cellY, zero), lastY) };
+			const __m256i x1{ _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(cellX, one), zero), lastX) };
+			const __m256i y1{ _mm256_min_epi32(_mm256_max_epi32(_mm256_add_epi32(cellY, one), zero), lastY) };
+
+			const __m256i column0{ _mm256_i32gather_epi32(pOffsetsX, x0, 4) };
+			const __m256i column1{ _mm256_i32gather_epi32(pOffsetsX, x1, 4) };
+			const __m256i row0{ _mm256_i32gather_epi32(pOffsetsY, y0, 4) };
+			const __m256i row1{ _mm256_i32gather_epi32(pOffsetsY, y1, 4) };
+
+			const __m256i topLeft{ _mm256_i32gather_epi32(pTexels, _mm256_add_epi32(row0, column0), 4) };
+			const __m256i topRight{ _mm256_i32gather_epi32(pTexels, _mm256_add_epi32(row0, column1), 4) };
+			const __m256i bottomLeft{ _mm256_i32gather_epi32(pTexels, _mm256_add_epi32(row1, column0), 4) };
+			const __m256i bottomRight{ _mm256_i32gather_epi32(pTexels, _mm256_add_epi32(row1, column1), 4) };
+
+			alignas(32) uint32_t filtered[8];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(filtered), BlendBilinear(topLeft, topRight, bottomLeft, bottomRight, weightX, weightY));
+
+			for (int lane{}; lane < 8; ++lane)
+			{
+				pColors[index + lane] = UnpackTexel(filtered[lane]);
+			}
+		}
+#endif
+
+		for (; index < count; ++index)
+		{
+			pColors[index] = UnpackTexel(FilterBilinear(level, pU[index], pV[index]));
+		}
+	}
+
+	//log2 of how many texels of the full resolution level one pixel step covers, along the longer of the two steps
+	float Texture::CalculateLevelOfDetail(const Vector2& uvDerivativeX, const Vector2& uvDerivativeY) const
+	{
+		const float width{ static_cast<float>(m_Width) };
+		const float height{ static_cast<float>(m_Height) };
 
-		const int rangeU{ static_cast<int>(uv.x * m_pSurface->w)};
-		const int rangeV{ static_cast<int>(uv.y * m_pSurface->h)};
+		const Vector2 texelDerivativeX{ uvDerivativeX.x * width, uvDerivativeX.y * height };
+		const Vector2 texelDerivativeY{ uvDerivativeY.x * width, uvDerivativeY.y * height };
+		const float footprintSquared{ std::max(texelDerivativeX.SqrMagnitude(), texelDerivativeY.SqrMagnitude()) };
 
-		const Uint32 pixel{ m_pSurfacePixels[(rangeV*m_pSurface->w) + rangeU] };
+		//Magnified, zero or NaN derivatives all read the full resolution level
+		const float levelOfDetail{ 0.5f * std::log2(footprintSquared) };
+		return (levelOfDetail > 0.f) ? levelOfDetail : 0.f;
+	}
+
+	ColorRGB Texture::SampleNearest(const MipLevel& level, const Vector2& uv) const
+	{
+		const int rangeU{ static_cast<int>(uv.x * level.width) };
+		const int rangeV{ static_cast<int>(uv.y * level.height) };
 
 		//Sample the correct texel for the given uv
-		SDL_GetRGB(pixel, m_pSurface->format, m_Red, m_Green, m_Blue);
+		return UnpackTexel(level.pTexels[level.pOffsetsY[rangeV] + level.pOffsetsX[rangeU]]);
+	}
+
+	uint32_t Texture::FilterBilinear(const MipLevel& level, float u, float v) const
+	{
+		//Texel centers sit at half coordinates, the four around the sample are blended, clamped at the edges
+		const float x{ u * level.width - 0.5f };
+		const float y{ v * level.height - 0.5f };
+		const float floorX{ std::floor(x) };
+		const float floorY{ std::floor(y) };
+
+		//Blend weights in 1/256 steps
+		const uint32_t weightX{ static_cast<uint32_t>(std::lrint((x - floorX) * 256.f)) };
+		const uint32_t weightY{ static_cast<uint32_t>(std::lrint((y - floorY) * 256.f)) };
+
+		const int x0{ std::clamp(static_cast<int>(floorX), 0, level.width - 1) };
+		const int y0{ std::clamp(static_cast<int>(floorY), 0, level.height - 1) };
+		const int x1{ std::clamp(static_cast<int>(floorX) + 1, 0, level.width - 1) };
+		const int y1{ std::clamp(static_cast<int>(floorY) + 1, 0, level.height - 1) };
+
+		const uint32_t topLeft{ level.pTexels[level.pOffsetsY[y0] + level.pOffsetsX[x0]] };
+		const uint32_t topRight{ level.pTexels[level.pOffsetsY[y0] + level.pOffsetsX[x1]] };
+		const uint32_t bottomLeft{ level.pTexels[level.pOffsetsY[y1] + level.pOffsetsX[x0]] };
+		const uint32_t bottomRight{ level.pTexels[level.pOffsetsY[y1] + level.pOffsetsX[x1]] };
+
+		uint32_t filtered{};
+		for (int shift{}; shift < 32; shift += 8)
+		{
+			const uint32_t top{ LerpFixedPoint((topLeft >> shift) & 0xFF, (topRight >> shift) & 0xFF, weightX) };
+			const uint32_t bottom{ LerpFixedPoint((bottomLeft >> shift) & 0xFF, (bottomRight >> shift) & 0xFF, weightX) };
+			filtered |= LerpFixedPoint(top, bottom, weightY) << shift;
+		}
 
-		return {static_cast<float>(*m_Red) / 255.f, static_cast<float>(*m_Green) / 255.f, static_cast<float>(*m_Blue) / 255.f};
+		return filtered;
 	}
 }
\ No newline at end of file
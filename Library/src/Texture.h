@@ -1,8 +1,11 @@
 #pragma once
-#include <SDL_surface.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "ColorRGB.h"
 
+struct SDL_Surface;
+
 namespace dae
 {
 	struct Vector2;
@@ -10,19 +13,87 @@ namespace dae
 	class Texture
 	{
 	public:
+		//How texels are ordered in memory, chosen when the texture is loaded
+		enum class Layout
+		{
+			linear,	//Row after row
+			tiled,	//4x4 blocks of 64 bytes, one cache line each, block after block
+			morton,	//Z-order curve, texels close in 2D stay close in memory at every scale
+			number
+		};
+
+		//How a sample with uv derivatives reads the mip chain
+		enum class Filter
+		{
+			point,		//Nearest texel of the full resolution level, the derivatives are ignored
+			bilinear,	//Four texels of the full resolution level blended, the derivatives are ignored
+			nearestMip,	//Nearest texel of the closest mip level
+			trilinear,	//Bilinear in the two closest mip levels, blended
+			number
+		};
+
 		~Texture();
 
-		static Texture* LoadFromFile(const std::string& path);
+		Texture(const Texture&) = delete;
+		Texture(Texture&&) noexcept = delete;
+		Texture& operator=(const Texture&) = delete;
+		Texture& operator=(Texture&&) noexcept = delete;
+
+		static Texture* LoadFromFile(const std::string& path, Layout layout = Layout::linear);
+
+		//A 1x1 texture of one color, every sample returns that color
+		static Texture* CreateFromColor(const ColorRGB& color, Layout layout = Layout::linear);
 		ColorRGB Sample(const Vector2& uv) const;
 
+		//uvDerivativeX and uvDerivativeY are how much the uv changes to the next pixel on the right and below
+		ColorRGB Sample(const Vector2& uv, const Vector2& uvDerivativeX, const Vector2& uvDerivativeY, Filter filter) const;
+
+		//Bilinear samples of the full resolution level for count uvs given as separate u and v arrays,
+		//eight at a time with AVX2, the results equal count single bilinear samples
+		void SampleBilinear(const float* pU, const float* pV, int count, ColorRGB* pColors) const;
+
+		static bool NeedsDerivatives(Filter filter) { return filter == Filter::nearestMip || filter == Filter::trilinear; };
+
+		int GetWidth() const { return m_Width; };
+		int GetHeight() const { return m_Height; };
+		Layout GetLayout() const { return m_Layout; };
+		int GetMipLevelCount() const { return static_cast<int>(m_MipLevels.size()); };
+
 	private:
-		Texture(SDL_Surface* pSurface);
+		//Every layout splits into a column and a row part, a texel lives at pOffsetsX[x] + pOffsetsY[y]
+		//Both have one extra entry repeating the edge, so a coordinate of exactly 1 stays inside the level
+		struct MipLevel
+		{
+			int width{};
+			int height{};
+
+			//One texel per uint32_t with red in the lowest byte, then green, blue and alpha
+			//Tiled and morton storage is padded up to whole blocks, those texels are never sampled
+			uint32_t* pTexels{ nullptr };
+			uint32_t* pOffsetsX{ nullptr };
+			uint32_t* pOffsetsY{ nullptr };
+		};
+
+		//pSurface holds SDL_PIXELFORMAT_ABGR8888 texels
+		Texture(SDL_Surface* pSurface, Layout layout);
+
+		//Stores linear texels of the given size as the next mip level, in the layout of the texture
+		void AddMipLevel(const std::vector<uint32_t>& texels, int width, int height);
+
+		//Fills the offset tables for the layout and returns how many texels the storage needs
+		uint32_t InitializeOffsets(MipLevel& level) const;
+
+		float CalculateLevelOfDetail(const Vector2& uvDerivativeX, const Vector2& uvDerivativeY) const;
+		ColorRGB SampleNearest(const MipLevel& level, const Vector2& uv) const;
+
+		//Blends in 8 bit fixed point, the result is a packed texel
+		uint32_t FilterBilinear(const MipLevel& level, float u, float v) const;
 
-		SDL_Surface* m_pSurface{ nullptr };
-		uint32_t* m_pSurfacePixels{ nullptr };
+		int m_Width{};
+		int m_Height{};
+		Layout m_Layout{ Layout::linear };
 
-		Uint8* m_Red{ nullptr };
-		Uint8* m_Green{ nullptr };
-		Uint8* m_Blue{ nullptr };
+		//Decoded once at load, the full resolution level first, down to 1x1
+		std::vector<MipLevel> m_MipLevels{};
 	};
 }
\ No newline at end of file
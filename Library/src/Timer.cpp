@@ -1,5 +1,10 @@
 #include "Timer.h"
 #include "SDL.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
 using namespace dae;
 
 Timer::Timer()
@@ -44,24 +49,58 @@ void Timer::Update()
 		return;
 	}
 
+	//The benchmark always times the real frame, also while simulated time runs at a fixed step
+	if (m_IsBenchmarkRunning)
+	{
+		const uint64_t currentTime = SDL_GetPerformanceCounter();
+		const float frameTime = (float)((currentTime - m_BenchmarkPreviousTime) * m_SecondsPerCount);
+		m_BenchmarkPreviousTime = currentTime;
+
+		if (m_BenchmarkWarmupFramesLeft > 0)
+		{
+			--m_BenchmarkWarmupFramesLeft;
+		}
+		else
+		{
+			m_BenchmarkFrameTimes.push_back(frameTime);
+			if (m_BenchmarkFrameTimes.size() >= m_BenchmarkMeasuredFrames)
+			{
+				m_IsBenchmarkRunning = false;
+				m_IsBenchmarkFinished = true;
+			}
+		}
+	}
+
 	const uint64_t currentTime = SDL_GetPerformanceCounter();
 	m_CurrentTime = currentTime;
 
-	m_ElapsedTime = (float)((m_CurrentTime - m_PreviousTime) * m_SecondsPerCount);
+	float frameTime = (float)((m_CurrentTime - m_PreviousTime) * m_SecondsPerCount);
 	m_PreviousTime = m_CurrentTime;
 
-	if (m_ElapsedTime < 0.0f)
-		m_ElapsedTime = 0.0f;
+	if (frameTime < 0.0f)
+		frameTime = 0.0f;
 
-	if (m_ForceElapsedUpperBound && m_ElapsedTime > m_ElapsedUpperBound)
+	//Simulated time no longer depends on how long the frame took, so every run sees the same frames
+	//The FPS still counts real frames
+	if (m_IsFixedElapsedOn)
 	{
-		m_ElapsedTime = m_ElapsedUpperBound;
+		m_ElapsedTime = m_FixedElapsed;
+		m_TotalTime += m_FixedElapsed;
 	}
+	else
+	{
+		m_ElapsedTime = frameTime;
 
-	m_TotalTime = (float)(((m_CurrentTime - m_PausedTime) - m_BaseTime) * m_SecondsPerCount);
+		if (m_ForceElapsedUpperBound && m_ElapsedTime > m_ElapsedUpperBound)
+		{
+			m_ElapsedTime = m_ElapsedUpperBound;
+		}
+
+		m_TotalTime = (float)(((m_CurrentTime - m_PausedTime) - m_BaseTime) * m_SecondsPerCount);
+	}
 
 	//FPS LOGIC
-	m_FPSTimer += m_ElapsedTime;
+	m_FPSTimer += frameTime;
 	++m_FPSCount;
 	if (m_FPSTimer >= 1.0f)
 	{
@@ -82,3 +121,95 @@ void Timer::Stop()
 		m_IsStopped = true;
 	}
 }
+
+void Timer::StartBenchmark(uint32_t warmupFrames, uint32_t measuredFrames, float fixedElapsed)
+{
+	m_BenchmarkWarmupFramesLeft = warmupFrames;
+	m_BenchmarkMeasuredFrames = std::max(measuredFrames, 1u);
+	m_BenchmarkFrameTimes.clear();
+	m_BenchmarkFrameTimes.reserve(m_BenchmarkMeasuredFrames);
+	m_BenchmarkPreviousTime = SDL_GetPerformanceCounter();
+
+	m_FixedElapsedBeforeBenchmark = m_FixedElapsed;
+	m_IsFixedElapsedOnBeforeBenchmark = m_IsFixedElapsedOn;
+	SetFixedElapsed(fixedElapsed);
+	m_TotalTime = 0.0f;
+
+	m_IsBenchmarkRunning = true;
+	m_IsBenchmarkFinished = false;
+}
+
+void Timer::EndBenchmark()
+{
+	m_FixedElapsed = m_FixedElapsedBeforeBenchmark;
+	m_IsFixedElapsedOn = m_IsFixedElapsedOnBeforeBenchmark;
+	m_IsBenchmarkRunning = false;
+	m_IsBenchmarkFinished = false;
+
+	//Writing the report took real time, it does not belong to the next frame
+	m_PreviousTime = SDL_GetPerformanceCounter();
+}
+
+Timer::BenchmarkResult Timer::GetBenchmarkResult() const
+{
+	BenchmarkResult result{};
+	if (m_BenchmarkFrameTimes.empty())
+		return result;
+
+	std::vector<float> sortedFrameTimes{ m_BenchmarkFrameTimes };
+	std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+
+	const size_t frameCount = sortedFrameTimes.size();
+
+	//Nearest rank percentile
+	const auto percentile = [&](float fraction)
+	{
+		const size_t rank = static_cast<size_t>(std::ceil(fraction * frameCount));
+		return sortedFrameTimes[std::clamp(rank, size_t{ 1 }, frameCount) - 1] * 1000.0f;
+	};
+
+	result.frameCount = static_cast<uint32_t>(frameCount);
+	result.mean = static_cast<float>(std::accumulate(sortedFrameTimes.begin(), sortedFrameTimes.end(), 0.0) / frameCount) * 1000.0f;
+	result.median = (frameCount % 2 == 1)
+		? sortedFrameTimes[frameCount / 2] * 1000.0f
+		: (sortedFrameTimes[frameCount / 2 - 1] + sortedFrameTimes[frameCount / 2]) * 0.5f * 1000.0f;
+	result.p95 = percentile(0.95f);
+	result.p99 = percentile(0.99f);
+	result.max = sortedFrameTimes.back() * 1000.0f;
+
+	return result;
+}
+
+bool Timer::WriteBenchmarkReport(const std::string& csvPath, const std::string& jsonPath) const
+{
+	const BenchmarkResult result = GetBenchmarkResult();
+
+	std::ofstream csvFile(csvPath);
+	if (!csvFile)
+		return false;
+
+	csvFile << "frames,mean_ms,median_ms,p95_ms,p99_ms,max_ms\n";
+	csvFile << result.frameCount << ',' << result.mean << ',' << result.median << ','
+		<< result.p95 << ',' << result.p99 << ',' << result.max << '\n';
+
+	std::ofstream jsonFile(jsonPath);
+	if (!jsonFile)
+		return false;
+
+	jsonFile << "{\n";
+	jsonFile << "\t\"frames\": " << result.frameCount << ",\n";
+	jsonFile << "\t\"mean_ms\": " << result.mean << ",\n";
+	jsonFile << "\t\"median_ms\": " << result.median << ",\n";
+	jsonFile << "\t\"p95_ms\": " << result.p95 << ",\n";
+	jsonFile << "\t\"p99_ms\": " << result.p99 << ",\n";
+	jsonFile << "\t\"max_ms\": " << result.max << ",\n";
+	jsonFile << "\t\"frame_times_ms\": [";
+	for (size_t frame = 0; frame < m_BenchmarkFrameTimes.size(); ++frame)
+	{
+		jsonFile << (frame == 0 ? "" : ", ") << m_BenchmarkFrameTimes[frame] * 1000.0f;
+	}
+	jsonFile << "]\n";
+	jsonFile << "}\n";
+
+	return static_cast<bool>(csvFile) && static_cast<bool>(jsonFile);
+}
@@ -2,12 +2,25 @@
 
 //Standard includes
 #include <cstdint>
+#include <string>
+#include <vector>
 
 namespace dae
 {
 	class Timer
 	{
 	public:
+		//Frame time statistics of a finished benchmark, in milliseconds
+		struct BenchmarkResult
+		{
+			uint32_t frameCount = 0;
+			float mean = 0.0f;
+			float median = 0.0f;
+			float p95 = 0.0f;
+			float p99 = 0.0f;
+			float max = 0.0f;
+		};
+
 		Timer();
 		virtual ~Timer() = default;
 
@@ -21,6 +34,19 @@ namespace dae
 		void Update();
 		void Stop();
 
+		//Advance the timer by a fixed step per Update instead of the wall clock, a step of 0 keeps the time still
+		void SetFixedElapsed(float seconds) { m_FixedElapsed = seconds; m_IsFixedElapsedOn = true; };
+		void ClearFixedElapsed() { m_IsFixedElapsedOn = false; };
+
+		//Runs warmupFrames untimed frames, then times measuredFrames frames with the wall clock
+		//Total time restarts at 0 and advances by fixedElapsed per frame, so every benchmark renders the same frames
+		void StartBenchmark(uint32_t warmupFrames = 60, uint32_t measuredFrames = 600, float fixedElapsed = 1.0f / 60.0f);
+		void EndBenchmark();
+		bool IsBenchmarkRunning() const { return m_IsBenchmarkRunning; };
+		bool IsBenchmarkFinished() const { return m_IsBenchmarkFinished; };
+		BenchmarkResult GetBenchmarkResult() const;
+		bool WriteBenchmarkReport(const std::string& csvPath, const std::string& jsonPath) const;
+
 		uint32_t GetFPS() const { return m_FPS; };
 		float GetdFPS() const { return m_dFPS; };
 		float GetElapsed() const { return m_ElapsedTime; };
@@ -43,8 +69,19 @@ namespace dae
 		float m_SecondsPerCount = 0.0f;
 		float m_ElapsedUpperBound = 0.03f;
 		float m_FPSTimer = 0.0f;
+		float m_FixedElapsed = 0.0f;
+
+		uint64_t m_BenchmarkPreviousTime = 0;
+		uint32_t m_BenchmarkWarmupFramesLeft = 0;
+		uint32_t m_BenchmarkMeasuredFrames = 0;
+		float m_FixedElapsedBeforeBenchmark = 0.0f;
+		bool m_IsFixedElapsedOnBeforeBenchmark = false;
+		std::vector<float> m_BenchmarkFrameTimes{};
+		bool m_IsBenchmarkRunning = false;
+		bool m_IsBenchmarkFinished = false;
 
 		bool m_IsStopped = true;
 		bool m_ForceElapsedUpperBound = false;
+		bool m_IsFixedElapsedOn = false;
 	};
 }
\ No newline at end of file
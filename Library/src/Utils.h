@@ -1,6 +1,7 @@
 #pragma once
 #include <cassert>
 #include <fstream>
+#include <unordered_map>
 #include "Maths.h"
 #include "DataTypes.h"
 
@@ -10,6 +11,30 @@ namespace dae
 {
 	namespace Utils
 	{
+		//OBJ face corner, a vertex is only unique per (position, uv, normal) index triple
+		struct ObjVertexKey
+		{
+			size_t position{};
+			size_t uv{};
+			size_t normal{};
+
+			bool operator==(const ObjVertexKey& other) const
+			{
+				return position == other.position && uv == other.uv && normal == other.normal;
+			}
+		};
+
+		struct ObjVertexKeyHash
+		{
+			size_t operator()(const ObjVertexKey& key) const
+			{
+				size_t hash{ std::hash<size_t>{}(key.position) };
+				hash ^= std::hash<size_t>{}(key.uv) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				hash ^= std::hash<size_t>{}(key.normal) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				return hash;
+			}
+		};
+
 		//Just parses vertices and indices
 #pragma warning(push)
 #pragma warning(disable : 4505) //Warning unreferenced local function
@@ -31,6 +56,9 @@ namespace dae
 			std::vector<Vector3> normals{};
 			std::vector<Vector2> UVs{};
 
+			//Face corners that were already emitted, shared corners reuse their vertex
+			std::unordered_map<ObjVertexKey, uint32_t, ObjVertexKeyHash> uniqueVertices{};
+
 			vertices.clear();
 			indices.clear();
 
@@ -76,12 +104,15 @@ namespace dae
 					//add the material index as attibute to the attribute array
 					//
 					// Faces or triangles
-					Vertex vertex{};
 					size_t iPosition, iTexCoord, iNormal;
 
 					uint32_t tempIndices[3];
 					for (size_t iFace = 0; iFace < 3; iFace++)
 					{
+						Vertex vertex{};
+						iTexCoord = 0;
+						iNormal = 0;
+
 						// OBJ format uses 1-based arrays
 						file >> iPosition;
 						vertex.position = positions[iPosition - 1];
@@ -107,8 +138,13 @@ namespace dae
 							}
 						}
 
-						vertices.push_back(vertex);
-						tempIndices[iFace] = uint32_t(vertices.size()) - 1;
+						//0 marks a missing uv or normal, OBJ indices start at 1
+						const auto [it, isNew] = uniqueVertices.try_emplace(ObjVertexKey{ iPosition, iTexCoord, iNormal }, uint32_t(vertices.size()));
+						if (isNew)
+						{
+							vertices.push_back(vertex);
+						}
+						tempIndices[iFace] = it->second;
 						//indices.push_back(uint32_t(vertices.size()) - 1);
 					}
 
@@ -148,6 +184,10 @@ namespace dae
 				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
 				float r = 1.f / Vector2::Cross(diffX, diffY);
 
+				//Degenerate uvs would spread a NaN tangent over every triangle sharing these vertices
+				if (!std::isfinite(r))
+					continue;
+
 				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
 				vertices[index0].tangent += tangent;
 				vertices[index1].tangent += tangent;
@@ -171,6 +211,183 @@ namespace dae
 			return true;
 #endif
 		}
+
+		static MeshBounds CalculateBounds(const std::vector<Vertex>& vertices)
+		{
+			MeshBounds bounds{};
+			if (vertices.empty())
+				return bounds;
+
+			bounds.minimum = vertices[0].position;
+			bounds.maximum = vertices[0].position;
+			for (const auto& v : vertices)
+			{
+				bounds.minimum = { std::min(bounds.minimum.x, v.position.x), std::min(bounds.minimum.y, v.position.y), std::min(bounds.minimum.z, v.position.z) };
+				bounds.maximum = { std::max(bounds.maximum.x, v.position.x), std::max(bounds.maximum.y, v.position.y), std::max(bounds.maximum.z, v.position.z) };
+			}
+
+			//Sphere around the box center, only as large as the farthest vertex needs
+			bounds.center = (bounds.minimum + bounds.maximum) * 0.5f;
+			for (const auto& v : vertices)
+			{
+				bounds.radius = std::max(bounds.radius, (v.position - bounds.center).Magnitude());
+			}
+
+			return bounds;
+		}
+
+		//Average cache miss ratio: vertices transformed per triangle with a FIFO post-transform cache, 0.5 is the ideal and 3 the worst
+		static float CalculateACMR(const std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize = 16)
+		{
+			if (indices.size() < 3)
+				return 0.f;
+
+			//Miss count at which each vertex entered the cache, 0 = never loaded
+			std::vector<size_t> loadedAt(vertexCount, 0);
+			size_t misses{};
+
+			for (const uint32_t index : indices)
+			{
+				if (loadedAt[index] == 0 || misses - loadedAt[index] >= cacheSize)
+				{
+					++misses;
+					loadedAt[index] = misses;
+				}
+			}
+
+			return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+		}
+
+		//Reorders a triangle list for vertex locality with Tipsify (Sander, Nehab and Barczak 2007):
+		//fan around the last emitted vertices that are still in the cache, fall back to dead ends, then to the next live vertex
+		static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize = 16)
+		{
+			const size_t triangleCount{ indices.size() / 3 };
+			if (triangleCount == 0 || vertexCount == 0)
+				return;
+
+			//Triangles using each vertex
+			std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+			for (const uint32_t index : indices)
+				++adjacencyOffsets[index + 1];
+			for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+				adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+
+			std::vector<uint32_t> adjacency(indices.size());
+			std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t corner = 0; corner < indices.size(); ++corner)
+				adjacency[fillOffsets[indices[corner]]++] = uint32_t(corner / 3);
+
+			std::vector<int> liveTriangles(vertexCount);
+			for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+				liveTriangles[vertex] = int(adjacencyOffsets[vertex + 1] - adjacencyOffsets[vertex]);
+
+			std::vector<int> cacheTimeStamps(vertexCount, 0);
+			std::vector<bool> isEmitted(triangleCount, false);
+			std::vector<uint32_t> deadEndStack{};
+			std::vector<uint32_t> candidates{};
+
+			std::vector<uint32_t> reordered{};
+			reordered.reserve(indices.size());
+
+			int timeStamp{ cacheSize + 1 };
+			size_t cursor{};
+			int fanningVertex{ 0 };
+
+			while (fanningVertex >= 0)
+			{
+				candidates.clear();
+
+				for (uint32_t adjacent = adjacencyOffsets[fanningVertex]; adjacent < adjacencyOffsets[fanningVertex + 1]; ++adjacent)
+				{
+					const uint32_t triangle{ adjacency[adjacent] };
+					if (isEmitted[triangle])
+						continue;
+
+					for (size_t corner = 0; corner < 3; ++corner)
+					{
+						const uint32_t vertex{ indices[triangle * size_t(3) + corner] };
+						reordered.push_back(vertex);
+						deadEndStack.push_back(vertex);
+						candidates.push_back(vertex);
+						--liveTriangles[vertex];
+
+						if (timeStamp - cacheTimeStamps[vertex] > cacheSize)
+							cacheTimeStamps[vertex] = timeStamp++;
+					}
+					isEmitted[triangle] = true;
+				}
+
+				//Next fanning vertex: the candidate with live triangles that stays in the cache the longest
+				int bestVertex{ -1 };
+				int bestPriority{ -1 };
+				for (const uint32_t vertex : candidates)
+				{
+					if (liveTriangles[vertex] <= 0)
+						continue;
+
+					int priority{ 0 };
+					if (timeStamp - cacheTimeStamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+						priority = timeStamp - cacheTimeStamps[vertex];
+
+					if (priority > bestPriority)
+					{
+						bestPriority = priority;
+						bestVertex = int(vertex);
+					}
+				}
+
+				//Dead end: most recently used vertex with live triangles, otherwise the next one in input order
+				while (bestVertex < 0 && !deadEndStack.empty())
+				{
+					const uint32_t vertex{ deadEndStack.back() };
+					deadEndStack.pop_back();
+					if (liveTriangles[vertex] > 0)
+						bestVertex = int(vertex);
+				}
+				while (bestVertex < 0 && cursor < vertexCount)
+				{
+					if (liveTriangles[cursor] > 0)
+						bestVertex = int(cursor);
+					++cursor;
+				}
+
+				fanningVertex = bestVertex;
+			}
+
+			indices = std::move(reordered);
+		}
+
+		//Renumbers vertices in the order the indices first use them, so fetches walk the vertex buffer forwards
+		//Vertices no index refers to are dropped
+		static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+			std::vector<Vertex> reordered{};
+			reordered.reserve(vertices.size());
+
+			for (uint32_t& index : indices)
+			{
+				if (remap[index] == UINT32_MAX)
+				{
+					remap[index] = uint32_t(reordered.size());
+					reordered.push_back(vertices[index]);
+				}
+				index = remap[index];
+			}
+
+			vertices = std::move(reordered);
+		}
+
+		//Parses vertices and indices straight into the mesh and calculates its bounds
+		static bool ParseOBJ(const std::string& filename, Mesh& mesh, bool flipAxisAndWinding = true)
+		{
+			if (!ParseOBJ(filename, mesh.vertices, mesh.indices, flipAxisAndWinding))
+				return false;
+
+			mesh.bounds = CalculateBounds(mesh.vertices);
+			return true;
+		}
 #pragma warning(pop)
 	}
 }
\ No newline at end of file
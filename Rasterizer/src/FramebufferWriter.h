@@ -0,0 +1,67 @@
+#pragma once
+#include <SDL_pixels.h>
+#include <cassert>
+#include <cstdint>
+
+#include "ColorRGB.h"
+
+//8-wide packing, only available when the compiler targets AVX2 (/arch:AVX2)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace dae
+{
+	//Packs colors into 32 bit surface pixels with plain shifts, the format is only looked at once per frame
+	class FramebufferWriter final
+	{
+	public:
+		void Initialize(const SDL_PixelFormat* pFormat)
+		{
+			//Shifts alone are only enough for 8 bits per channel, which is what the back buffer is created with
+			assert(pFormat->BytesPerPixel == 4 && pFormat->Rloss == 0 && pFormat->Gloss == 0 && pFormat->Bloss == 0);
+
+			m_RedShift = pFormat->Rshift;
+			m_GreenShift = pFormat->Gshift;
+			m_BlueShift = pFormat->Bshift;
+			m_AlphaMask = pFormat->Amask;
+		}
+
+		//Same result as SDL_MapRGB
+		uint32_t Pack(uint8_t red, uint8_t green, uint8_t blue) const
+		{
+			return (uint32_t{ red } << m_RedShift) | (uint32_t{ green } << m_GreenShift) | (uint32_t{ blue } << m_BlueShift) | m_AlphaMask;
+		}
+
+		//Expects a color in [0, 1], see ColorRGB::MaxToOne
+		uint32_t Pack(const ColorRGB& color) const
+		{
+			return Pack(static_cast<uint8_t>(color.r * 255), static_cast<uint8_t>(color.g * 255), static_cast<uint8_t>(color.b * 255));
+		}
+
+#if defined(__AVX2__)
+		//8 colors at once, truncating exactly like the scalar Pack
+		__m256i Pack(__m256 red, __m256 green, __m256 blue) const
+		{
+			const __m256 scale{ _mm256_set1_ps(255.f) };
+
+			const __m256i redBytes{ _mm256_cvttps_epi32(_mm256_mul_ps(red, scale)) };
+			const __m256i greenBytes{ _mm256_cvttps_epi32(_mm256_mul_ps(green, scale)) };
+			const __m256i blueBytes{ _mm256_cvttps_epi32(_mm256_mul_ps(blue, scale)) };
+
+			__m256i pixels{ _mm256_set1_epi32(static_cast<int>(m_AlphaMask)) };
+			pixels = _mm256_or_si256(pixels, _mm256_sllv_epi32(redBytes, _mm256_set1_epi32(static_cast<int>(m_RedShift))));
+			pixels = _mm256_or_si256(pixels, _mm256_sllv_epi32(greenBytes, _mm256_set1_epi32(static_cast<int>(m_GreenShift))));
+			pixels = _mm256_or_si256(pixels, _mm256_sllv_epi32(blueBytes, _mm256_set1_epi32(static_cast<int>(m_BlueShift))));
+
+			return pixels;
+		}
+#endif
+
+	private:
+		uint32_t m_RedShift{};
+		uint32_t m_GreenShift{};
+		uint32_t m_BlueShift{};
+		uint32_t m_AlphaMask{};
+	};
+}
@@ -0,0 +1,117 @@
+//Project includes
+#include "PrimitiveAssembler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace dae;
+
+void PrimitiveAssembler::ResolveTopology(const Mesh& mesh, std::vector<uint32_t>& triangleIndices)
+{
+	triangleIndices.clear();
+
+	const std::vector<uint32_t>& indices{ mesh.indices };
+	const bool isStrip{ mesh.primitiveTopology == PrimitiveTopology::TriangleStrip };
+
+	//A list advances a whole triangle, a strip one vertex
+	const size_t step{ isStrip ? size_t{ 1 } : size_t{ 3 } };
+
+	for (size_t first{}; first + 2 < indices.size(); first += step)
+	{
+		++m_TrianglesSubmitted;
+
+		uint32_t vertex0{ indices[first] };
+		uint32_t vertex1{ indices[first + 1] };
+		uint32_t vertex2{ indices[first + 2] };
+
+		//Strips restart by repeating an index, those triangles have no area
+		if (vertex0 == vertex1 || vertex1 == vertex2 || vertex2 == vertex0)
+		{
+			++m_TrianglesCulled[static_cast<int>(CullReason::degenerate)];
+			continue;
+		}
+
+		//Every odd strip triangle has the opposite winding
+		if (isStrip && (first % 2) == 1)
+		{
+			std::swap(vertex1, vertex2);
+		}
+
+		triangleIndices.push_back(vertex0);
+		triangleIndices.push_back(vertex1);
+		triangleIndices.push_back(vertex2);
+	}
+}
+
+void PrimitiveAssembler::Clear()
+{
+	m_Triangles.clear();
+	m_Batches.clear();
+
+	m_TrianglesSubmitted = 0;
+	std::fill_n(m_TrianglesCulled, static_cast<int>(CullReason::number), 0);
+}
+
+void PrimitiveAssembler::Submit(uint32_t meshIndex, uint32_t vertex0, uint32_t vertex1, uint32_t vertex2, const VertexStreams& streams)
+{
+	const Vector2 v0{ streams.positionX[vertex0], streams.positionY[vertex0] };
+	const Vector2 v1{ streams.positionX[vertex1], streams.positionY[vertex1] };
+	const Vector2 v2{ streams.positionX[vertex2], streams.positionY[vertex2] };
+
+	//Screen y points down, so clockwise (front facing) triangles have a positive area
+	const float doubleTriangleArea{ Vector2::Cross(v1 - v0, v2 - v0) };
+
+	//Zero-area triangles never cover a pixel center, NaN areas come from degenerate projections
+	if (doubleTriangleArea == 0.f || std::isnan(doubleTriangleArea))
+	{
+		++m_TrianglesCulled[static_cast<int>(CullReason::degenerate)];
+		return;
+	}
+
+	if
+		(
+			(m_CullMode == CullMode::back && doubleTriangleArea < 0.f) ||
+			(m_CullMode == CullMode::front && doubleTriangleArea > 0.f)
+		)
+	{
+		++m_TrianglesCulled[static_cast<int>(CullReason::facing)];
+		return;
+	}
+
+	Triangle triangle{ meshIndex, vertex0, vertex1, vertex2 };
+	triangle.doubleArea = doubleTriangleArea;
+
+	if (m_Batches.empty() || m_Batches.back().triangleCount == BATCH_SIZE)
+	{
+		m_Batches.push_back({ static_cast<uint32_t>(m_Triangles.size()), 0 });
+	}
+
+	m_Triangles.push_back(triangle);
+	++m_Batches.back().triangleCount;
+}
+
+std::vector<Triangle>& PrimitiveAssembler::GetTriangles()
+{
+	return m_Triangles;
+}
+
+const std::vector<PrimitiveAssembler::TriangleBatch>& PrimitiveAssembler::GetBatches() const
+{
+	return m_Batches;
+}
+
+uint32_t PrimitiveAssembler::GetTrianglesSubmitted() const
+{
+	return m_TrianglesSubmitted;
+}
+
+uint32_t PrimitiveAssembler::GetTrianglesCulled(CullReason reason) const
+{
+	return m_TrianglesCulled[static_cast<int>(reason)];
+}
+
+void PrimitiveAssembler::CycleCullMode()
+{
+	m_CullMode = static_cast<CullMode>((static_cast<int>(m_CullMode) + 1) % static_cast<int>(CullMode::number));
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "DataTypes.h"
+
+namespace dae
+{
+	//Turns any topology into culled triangles, grouped in fixed-size batches for bulk setup
+	class PrimitiveAssembler final
+	{
+	public:
+		static constexpr uint32_t BATCH_SIZE{ 256 };
+
+		enum class CullMode
+		{
+			none,
+			back,
+			front,
+			number
+		};
+
+		enum class CullReason
+		{
+			degenerate,
+			facing,
+			number
+		};
+
+		//A run of at most BATCH_SIZE consecutive triangles
+		struct TriangleBatch
+		{
+			uint32_t firstTriangle{};
+			uint32_t triangleCount{};
+		};
+
+		PrimitiveAssembler() = default;
+		~PrimitiveAssembler() = default;
+
+		PrimitiveAssembler(const PrimitiveAssembler&) = delete;
+		PrimitiveAssembler(PrimitiveAssembler&&) noexcept = delete;
+		PrimitiveAssembler& operator=(const PrimitiveAssembler&) = delete;
+		PrimitiveAssembler& operator=(PrimitiveAssembler&&) noexcept = delete;
+
+		//Index triples of every non-degenerate triangle, strips get their odd triangles' winding fixed
+		void ResolveTopology(const Mesh& mesh, std::vector<uint32_t>& triangleIndices);
+
+		void Clear();
+		void Submit(uint32_t meshIndex, uint32_t vertex0, uint32_t vertex1, uint32_t vertex2, const VertexStreams& streams);
+
+		std::vector<Triangle>& GetTriangles();
+		const std::vector<TriangleBatch>& GetBatches() const;
+
+		//Every triangle the topology resolved, clipping pieces are not counted again
+		uint32_t GetTrianglesSubmitted() const;
+		uint32_t GetTrianglesCulled(CullReason reason) const;
+
+		void CycleCullMode();
+
+	private:
+		//Both windings rasterize and nothing checks the winding of the OBJ files, so culling is opt-in with F10
+		CullMode m_CullMode{ CullMode::none };
+
+		std::vector<Triangle> m_Triangles{};
+		std::vector<TriangleBatch> m_Batches{};
+
+		uint32_t m_TrianglesSubmitted{};
+		uint32_t m_TrianglesCulled[static_cast<int>(CullReason::number)]{};
+	};
+}
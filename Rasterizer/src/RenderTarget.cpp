@@ -0,0 +1,58 @@
+//External includes
+#include "SDL.h"
+#include "SDL_surface.h"
+
+//Project includes
+#include "RenderTarget.h"
+
+using namespace dae;
+
+namespace
+{
+	int GetWindowWidth(SDL_Window* pWindow)
+	{
+		int width{};
+		SDL_GetWindowSize(pWindow, &width, nullptr);
+		return width;
+	}
+
+	int GetWindowHeight(SDL_Window* pWindow)
+	{
+		int height{};
+		SDL_GetWindowSize(pWindow, nullptr, &height);
+		return height;
+	}
+}
+
+RenderTarget::RenderTarget(int width, int height) :
+	m_Width(width),
+	m_Height(height)
+{
+	//A software surface, creating it does not touch the video subsystem
+	m_pColorBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
+	m_pDepthBuffer = new float[m_Width * m_Height];
+}
+
+RenderTarget::~RenderTarget()
+{
+	SDL_FreeSurface(m_pColorBuffer);
+	delete[] m_pDepthBuffer;
+}
+
+bool RenderTarget::SaveColorBuffer(const std::string& path) const
+{
+	return SDL_SaveBMP(m_pColorBuffer, path.c_str()) == 0;
+}
+
+WindowRenderTarget::WindowRenderTarget(SDL_Window* pWindow) :
+	RenderTarget(GetWindowWidth(pWindow), GetWindowHeight(pWindow)),
+	m_pWindow(pWindow),
+	m_pFrontBuffer(SDL_GetWindowSurface(pWindow))
+{
+}
+
+void WindowRenderTarget::Present()
+{
+	SDL_BlitSurface(GetColorBuffer(), 0, m_pFrontBuffer, 0);
+	SDL_UpdateWindowSurface(m_pWindow);
+}
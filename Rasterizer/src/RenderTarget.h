@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+
+struct SDL_Window;
+struct SDL_Surface;
+
+namespace dae
+{
+	//Color and depth buffer the renderer draws into, plain memory that needs no SDL video subsystem
+	class RenderTarget
+	{
+	public:
+		RenderTarget(int width, int height);
+		virtual ~RenderTarget();
+
+		RenderTarget(const RenderTarget&) = delete;
+		RenderTarget(RenderTarget&&) noexcept = delete;
+		RenderTarget& operator=(const RenderTarget&) = delete;
+		RenderTarget& operator=(RenderTarget&&) noexcept = delete;
+
+		//Called once the frame is finished, an in-memory target has nothing to show
+		virtual void Present() {};
+
+		bool SaveColorBuffer(const std::string& path) const;
+
+		int GetWidth() const { return m_Width; };
+		int GetHeight() const { return m_Height; };
+		SDL_Surface* GetColorBuffer() const { return m_pColorBuffer; };
+		float* GetDepthBuffer() const { return m_pDepthBuffer; };
+
+	private:
+		int m_Width{};
+		int m_Height{};
+
+		SDL_Surface* m_pColorBuffer{};
+		float* m_pDepthBuffer{};
+	};
+
+	//Shows every finished frame in a window
+	class WindowRenderTarget final : public RenderTarget
+	{
+	public:
+		explicit WindowRenderTarget(SDL_Window* pWindow);
+		~WindowRenderTarget() override = default;
+
+		WindowRenderTarget(const WindowRenderTarget&) = delete;
+		WindowRenderTarget(WindowRenderTarget&&) noexcept = delete;
+		WindowRenderTarget& operator=(const WindowRenderTarget&) = delete;
+		WindowRenderTarget& operator=(WindowRenderTarget&&) noexcept = delete;
+
+		void Present() override;
+
+	private:
+		SDL_Window* m_pWindow{};
+		SDL_Surface* m_pFrontBuffer{};
+	};
+}
@@ -5,369 +5,1564 @@
 //Project includes
 #include "Renderer.h"
 
+#include <algorithm>
+#include <bit>
 #include <execution>
 #include <iostream>
+#include <iterator>
+#include <numeric>
 
 #include "Maths.h"
+#include "Profiler.h"
+#include "RenderTarget.h"
 #include "Texture.h"
 #include "Utils.h"
 
 #define PARALLEL_EXECUTION
 
+//8-wide raster path, only available when the compiler targets AVX2 (/arch:AVX2)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_RASTERIZATION
+#endif
+
 using namespace dae;
 
-Renderer::Renderer(SDL_Window* pWindow) :
-	m_pWindow(pWindow),
-	m_DepthBufferOn(false),
-	m_RotatingOn(true),
-	m_NormalMappingOn(true),
-	m_Ambient({ 0.03f, 0.03f, 0.03f }),
-	m_Shininess(25.f)
-{
-	//Initialize
-	SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+//Pixel kernels specialized for one shading state, picked once per frame
+struct Renderer::PixelKernels
+{
+	VertexAttributes attributes{};
+	bool overdrawView{};
+	bool (Renderer::*pRasterizeBlockScalar)(uint32_t, const TriangleBoundingBox&, Tile&) {};
+#ifdef SIMD_RASTERIZATION
+	bool (Renderer::*pRasterizeBlockSIMD)(uint32_t, const TriangleBoundingBox&, Tile&) {};
+#endif
+	void (Renderer::*pResolveTile)(Tile&) {};
+
+	template<typename State>
+	static PixelKernels Create()
+	{
+		PixelKernels kernels{};
+		kernels.attributes = State::attributes;
+		kernels.overdrawView = State::overdrawView;
+		kernels.pRasterizeBlockScalar = &Renderer::RasterizeBlockScalar<State>;
+#ifdef SIMD_RASTERIZATION
+		kernels.pRasterizeBlockSIMD = &Renderer::RasterizeBlockSIMD<State>;
+#endif
+		kernels.pResolveTile = &Renderer::ResolveTile<State>;
+
+		return kernels;
+	}
+};
+
+//Texture samples of the pixels of one span, an array per texture so the batched sampler fills them directly
+struct Renderer::SpanTextureSamples
+{
+	ColorRGB diffuse[SHADING_SPAN_WIDTH]{};
+	ColorRGB normal[SHADING_SPAN_WIDTH]{};
+	ColorRGB gloss[SHADING_SPAN_WIDTH]{};
+	ColorRGB specular[SHADING_SPAN_WIDTH]{};
+};
+
+Renderer::Renderer(RenderTarget* pRenderTarget) :
+	Renderer(pRenderTarget, SceneDescription{})
+{
+}
+
+Renderer::Renderer(RenderTarget* pRenderTarget, const SceneDescription& scene) :
+	m_pRenderTarget(pRenderTarget),
+	m_Scene(scene),
+	m_DepthBufferOn(false),
+	m_RotatingOn(true),
+	m_NormalMappingOn(true),
+	m_SIMDRasterizationOn(true),
+	m_DeferredShadingOn(false),
+	m_Ambient({ 0.03f, 0.03f, 0.03f }),
+	m_Shininess(25.f)
+{
+	//Initialize
+	m_Width = m_pRenderTarget->GetWidth();
+	m_Height = m_pRenderTarget->GetHeight();
+
+	//The render target owns the color and depth buffer
+	m_pBackBuffer = m_pRenderTarget->GetColorBuffer();
+	m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
+
+	m_pDepthBufferPixels = m_pRenderTarget->GetDepthBuffer();
+
+	//Farthest depth per 8x8 block of the depth buffer
+	m_HiZBlockCount = ((m_Width + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE) * ((m_Height + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE);
+	m_pHiZMaxDepth = new float[m_HiZBlockCount];
+
+	m_pVisibilityBufferPixels = new uint32_t[m_Width * m_Height];
+	m_pOverdrawPixels = new uint32_t[m_Width * m_Height];
+
+	//Initialize Camera
+	m_Camera.Initialize(static_cast<float>(m_Width) / m_Height, 45.f, { .0f,.5f, -64.f });
+
+	LoadTextures();
+
+	m_Meshes.push_back(Mesh{});
+	m_Meshes[0].primitiveTopology = PrimitiveTopology::TriangleList;
+	Utils::ParseOBJ(scene.meshPath, m_Meshes[0]);
+
+	//Reorder the triangle list for vertex locality, this renderer has no post-transform cache
+	//but setup and shading fetch vertices_out in index order
+	Mesh& mesh{ m_Meshes[0] };
+	const float acmrBefore{ scene.reportMeshStatistics ? Utils::CalculateACMR(mesh.indices, mesh.vertices.size()) : 0.f };
+	Utils::OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+	Utils::OptimizeVertexFetch(mesh.vertices, mesh.indices);
+
+	if (scene.reportMeshStatistics)
+	{
+		std::cout << scene.meshPath << ": " << mesh.vertices.size() << " vertices, " << mesh.indices.size() / 3 << " triangles"
+			<< " | ACMR " << acmrBefore << " -> " << Utils::CalculateACMR(mesh.indices, mesh.vertices.size()) << std::endl;
+	}
+	m_Meshes[0].worldMatrix =
+	{
+		Matrix{}
+	};
+
+	size_t maxVertexCount{};
+	for (const Mesh& loadedMesh : m_Meshes)
+	{
+		maxVertexCount = std::max(maxVertexCount, loadedMesh.vertices.size());
+	}
+	m_VertexIndices.resize(maxVertexCount);
+	std::iota(m_VertexIndices.begin(), m_VertexIndices.end(), 0u);
+
+	InitializeTiles();
+	SelectPixelKernels();
+}
+
+Renderer::~Renderer()
+{
+	delete[] m_pHiZMaxDepth;
+	delete[] m_pVisibilityBufferPixels;
+	delete[] m_pOverdrawPixels;
+
+	delete m_pTextureDiffuse;
+	delete m_pTextureGloss;
+	delete m_pTextureNormal;
+	delete m_pTextureSpecular;
+}
+
+void Renderer::Update(Timer* pTimer)
+{
+	m_Camera.Update(pTimer);
+	if(m_RotatingOn)
+	{
+		m_Meshes[0].worldMatrix = Matrix::CreateRotationY(pTimer->GetTotal() / 2) * Matrix::CreateTranslation(m_Scene.meshPosition);
+	}
+}
+
+void Renderer::Render()
+{
+	PROFILE_ZONE("Render");
+
+	//Every pass below only adds to the counters of this frame
+	m_FrameStatistics = {};
+
+	//@START
+	//Lock BackBuffer
+	SDL_LockSurface(m_pBackBuffer);
+
+	//The pixel format is only looked up once per frame, tiles clear their own part of every buffer
+	m_FramebufferWriter.Initialize(m_pBackBuffer->format);
+	m_ClearPixel = m_FramebufferWriter.Pack(Uint8{ 100 }, Uint8{ 100 }, Uint8{ 100 });
+
+	//Pick the pixel kernels for this frame's shading state, the transform only writes what they read
+	SelectPixelKernels();
+
+	//Skip every mesh whose bounds are outside the view frustum
+	CullMeshes();
+
+	VertexTransformationFunction(m_Meshes);
+
+	//Turn the meshes into culled and clipped triangles
+	AssemblePrimitives();
+
+	//Sort the triangles into screen tiles
+	BinTriangles();
+
+	//RENDER LOGIC
+	//Every tile owns its own region of the back and depth buffer, so tiles can be rendered without locking
+	{
+		PROFILE_ZONE("RenderTiles");
+#ifdef PARALLEL_EXECUTION
+		std::for_each(std::execution::par, m_Tiles.begin(), m_Tiles.end(), [this](Tile& tile)
+			{
+				RenderTile(tile);
+			});
+#else
+		for (Tile& tile : m_Tiles)
+		{
+			RenderTile(tile);
+		}
+#endif
+	}
+
+	for (const Tile& tile : m_Tiles)
+	{
+		m_FrameStatistics.trianglesCulledHiZ += tile.trianglesCulledHiZ;
+		m_FrameStatistics.trianglesRasterized += tile.trianglesRasterized;
+		m_FrameStatistics.pixelsTested += tile.pixelsTested;
+		m_FrameStatistics.pixelsPassedDepth += tile.pixelsPassedDepth;
+		m_FrameStatistics.pixelsShaded += tile.pixelsShaded;
+	}
+
+	//@END
+	//Update SDL Surface
+	SDL_UnlockSurface(m_pBackBuffer);
+
+	PROFILE_ZONE("Present");
+	m_pRenderTarget->Present();
+}
+
+void Renderer::LoadTextures()
+{
+	delete m_pTextureDiffuse;
+	delete m_pTextureGloss;
+	delete m_pTextureNormal;
+	delete m_pTextureSpecular;
+
+	//Every shading mode can sample every texture, so a missing one gets a 1x1 stand-in instead of staying null
+	const auto loadTexture = [this](const std::string& path, const ColorRGB& fallbackColor)
+		{
+			Texture* pTexture{ path.empty() ? nullptr : Texture::LoadFromFile(path, m_Scene.texelLayout) };
+			return pTexture ? pTexture : Texture::CreateFromColor(fallbackColor, m_Scene.texelLayout);
+		};
+
+	m_pTextureDiffuse = loadTexture(m_Scene.diffuseTexturePath, colors::Gray);
+	m_pTextureGloss = loadTexture(m_Scene.glossTexturePath, colors::Black);
+	m_pTextureNormal = loadTexture(m_Scene.normalTexturePath, ColorRGB{ 0.5f, 0.5f, 1.f });
+	m_pTextureSpecular = loadTexture(m_Scene.specularTexturePath, colors::Black);
+}
+
+void Renderer::InitializeTiles()
+{
+	const int tileCountX{ (m_Width + TILE_SIZE - 1) / TILE_SIZE };
+	const int tileCountY{ (m_Height + TILE_SIZE - 1) / TILE_SIZE };
+
+	m_Tiles.resize(static_cast<size_t>(tileCountX) * tileCountY);
+
+	for (int tileY{}; tileY < tileCountY; ++tileY)
+	{
+		for (int tileX{}; tileX < tileCountX; ++tileX)
+		{
+			TriangleBoundingBox& boundingBox{ m_Tiles[tileX + (tileY * tileCountX)].boundingBox };
+			boundingBox.minX = tileX * TILE_SIZE;
+			boundingBox.minY = tileY * TILE_SIZE;
+			boundingBox.maxX = std::min(boundingBox.minX + TILE_SIZE, m_Width);
+			boundingBox.maxY = std::min(boundingBox.minY + TILE_SIZE, m_Height);
+		}
+	}
+}
+
+void Renderer::CullMeshes()
+{
+	PROFILE_ZONE("CullMeshes");
+
+	for (Mesh& mesh : m_Meshes)
+	{
+		mesh.isVisible = IsInsideFrustum(mesh);
+		m_FrameStatistics.meshesCulled += !mesh.isVisible;
+	}
+}
+
+bool Renderer::IsInsideFrustum(const Mesh& mesh) const
+{
+	//Planes are taken from the columns of the world view projection matrix, so they live in object space
+	//A clip space point is inside when -w <= x <= w, -w <= y <= w and 0 <= z <= w
+	const Matrix worldViewProjectionMatrix{ mesh.worldMatrix * m_Camera.viewMatrix * m_Camera.projectionMatrix };
+
+	Vector4 columns[4]{};
+	for (int column{}; column < 4; ++column)
+	{
+		columns[column] =
+		{
+			worldViewProjectionMatrix[0][column],
+			worldViewProjectionMatrix[1][column],
+			worldViewProjectionMatrix[2][column],
+			worldViewProjectionMatrix[3][column]
+		};
+	}
+
+	const Vector4 frustumPlanes[]
+	{
+		columns[3] + columns[0],	//Left
+		columns[3] - columns[0],	//Right
+		columns[3] + columns[1],	//Bottom
+		columns[3] - columns[1],	//Top
+		columns[2],					//z >= 0
+		columns[3] - columns[2]		//z <= w
+	};
+
+	const MeshBounds& bounds{ mesh.bounds };
+
+	for (const Vector4& plane : frustumPlanes)
+	{
+		const Vector3 normal{ plane.x, plane.y, plane.z };
+		const float normalLength{ normal.Magnitude() };
+
+		//Cheap sphere test first
+		if (Vector3::Dot(normal, bounds.center) + plane.w < -bounds.radius * normalLength)
+		{
+			return false;
+		}
+
+		//Then the box corner farthest along the plane normal
+		const Vector3 farthestCorner
+		{
+			normal.x >= 0.f ? bounds.maximum.x : bounds.minimum.x,
+			normal.y >= 0.f ? bounds.maximum.y : bounds.minimum.y,
+			normal.z >= 0.f ? bounds.maximum.z : bounds.minimum.z
+		};
+
+		if (Vector3::Dot(normal, farthestCorner) + plane.w < 0.f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Renderer::AssemblePrimitives()
+{
+	PROFILE_ZONE("AssemblePrimitives");
+
+	m_PrimitiveAssembler.Clear();
+
+	for (uint32_t meshIndex{}; meshIndex < static_cast<uint32_t>(m_Meshes.size()); ++meshIndex)
+	{
+		const Mesh& mesh{ m_Meshes[meshIndex] };
+		if (!mesh.isVisible)
+		{
+			continue;
+		}
+		const Matrix worldViewProjectionMatrix{ mesh.worldMatrix * m_Camera.viewMatrix * m_Camera.projectionMatrix };
+
+		m_PrimitiveAssembler.ResolveTopology(mesh, m_ResolvedIndices);
+
+		for (size_t index{}; index < m_ResolvedIndices.size(); index += 3)
+		{
+			const uint32_t vertex0{ m_ResolvedIndices[index] };
+			const uint32_t vertex1{ m_ResolvedIndices[index + 1] };
+			const uint32_t vertex2{ m_ResolvedIndices[index + 2] };
+
+			//Most triangles need no clipping at all
+			if
+				(
+					IsInsideClipVolume(mesh.vertices_out.GetPosition(vertex0)) &&
+					IsInsideClipVolume(mesh.vertices_out.GetPosition(vertex1)) &&
+					IsInsideClipVolume(mesh.vertices_out.GetPosition(vertex2))
+				)
+			{
+				m_PrimitiveAssembler.Submit(meshIndex, vertex0, vertex1, vertex2, mesh.vertices_out);
+			}
+			else
+			{
+				ClipTriangle(meshIndex, vertex0, vertex1, vertex2, worldViewProjectionMatrix);
+			}
+		}
+	}
+
+	m_FrameStatistics.trianglesSubmitted = m_PrimitiveAssembler.GetTrianglesSubmitted();
+	m_FrameStatistics.trianglesCulledDegenerate = m_PrimitiveAssembler.GetTrianglesCulled(PrimitiveAssembler::CullReason::degenerate);
+	m_FrameStatistics.trianglesCulledFacing = m_PrimitiveAssembler.GetTrianglesCulled(PrimitiveAssembler::CullReason::facing);
+}
+
+void Renderer::BinTriangles()
+{
+	PROFILE_ZONE("TriangleSetup");
+
+	for (Tile& tile : m_Tiles)
+	{
+		tile.triangleIndices.clear();
+		tile.maxDepth = INFINITY;
+	}
+
+	std::vector<Triangle>& triangles{ m_PrimitiveAssembler.GetTriangles() };
+	const std::vector<PrimitiveAssembler::TriangleBatch>& batches{ m_PrimitiveAssembler.GetBatches() };
+
+	//Setup only touches its own triangle, so every batch is set up in bulk on its own worker
+	const auto setupBatch = [&](const PrimitiveAssembler::TriangleBatch& batch)
+		{
+			for (uint32_t index{ batch.firstTriangle }; index < batch.firstTriangle + batch.triangleCount; ++index)
+			{
+				SetupTriangle(triangles[index]);
+			}
+		};
+
+#ifdef PARALLEL_EXECUTION
+	std::for_each(std::execution::par, batches.begin(), batches.end(), setupBatch);
+#else
+	std::for_each(batches.begin(), batches.end(), setupBatch);
+#endif
+
+	//Binning keeps submission order, so every tile resolves equal depths the same way
+	for (uint32_t triangleIndex{}; triangleIndex < static_cast<uint32_t>(triangles.size()); ++triangleIndex)
+	{
+		BinTriangle(triangleIndex);
+	}
+}
+
+bool Renderer::IsInsideClipVolume(const Vector4& position) const
+{
+	//After VertexTransformationFunction position holds screen x and y, NDC z and 1 / w
+	//Written so a NaN counts as outside and ends up in the clipper
+	const float ndcX{ ((position.x / static_cast<float>(m_Width)) * 2.f) - 1.f };
+	const float ndcY{ 1.f - ((position.y / static_cast<float>(m_Height)) * 2.f) };
+
+	return
+		(position.w > 0.f) &&
+		(position.z >= 0.f && position.z <= 1.f) &&
+		(std::abs(ndcX) <= GUARD_BAND && std::abs(ndcY) <= GUARD_BAND);
+}
+
+void Renderer::ClipTriangle(uint32_t meshIndex, uint32_t vertex0, uint32_t vertex1, uint32_t vertex2, const Matrix& worldViewProjectionMatrix)
+{
+	Mesh& mesh{ m_Meshes[meshIndex] };
+
+	const VertexAttributes& attributes{ mesh.vertices_out.attributes };
+
+	Vertex_Out polygon[MAX_CLIP_POLYGON_SIZE]
+	{
+		TransformVertex(mesh.vertices[vertex0], worldViewProjectionMatrix, mesh.worldMatrix, attributes),
+		TransformVertex(mesh.vertices[vertex1], worldViewProjectionMatrix, mesh.worldMatrix, attributes),
+		TransformVertex(mesh.vertices[vertex2], worldViewProjectionMatrix, mesh.worldMatrix, attributes)
+	};
+
+	const int polygonSize{ ClipPolygon(polygon, 3) };
+	if (polygonSize == 0)
+	{
+		++m_FrameStatistics.trianglesCulledClipped;
+		return;
+	}
+
+	//Project the clipped polygon and feed it to the rasterizer as a triangle fan
+	const uint32_t firstVertex{ static_cast<uint32_t>(mesh.vertices_out.Size()) };
+	for (int index{}; index < polygonSize; ++index)
+	{
+		ProjectToScreen(polygon[index]);
+		mesh.vertices_out.PushBack(polygon[index]);
+	}
+
+	for (int index{ 1 }; index < polygonSize - 1; ++index)
+	{
+		m_PrimitiveAssembler.Submit(meshIndex, firstVertex, firstVertex + index, firstVertex + index + 1, mesh.vertices_out);
+	}
+}
+
+int Renderer::ClipPolygon(Vertex_Out* pPolygon, int polygonSize)
+{
+	//A clip space position p is inside a plane when Dot(plane, p) >= 0
+	//The projection maps the near plane to NDC z = 1 and the far plane to NDC z = 0
+	static const Vector4 clipPlanes[]
+	{
+		{ 0.f, 0.f, -1.f, 1.f },		//Near: z <= w
+		{ 0.f, 0.f, 1.f, 0.f },			//Far: z >= 0
+		{ -1.f, 0.f, 0.f, GUARD_BAND },	//Guard band: |x| <= GUARD_BAND * w, |y| <= GUARD_BAND * w
+		{ 1.f, 0.f, 0.f, GUARD_BAND },
+		{ 0.f, -1.f, 0.f, GUARD_BAND },
+		{ 0.f, 1.f, 0.f, GUARD_BAND }
+	};
+	static_assert(MAX_CLIP_POLYGON_SIZE == 3 + std::size(clipPlanes));
+
+	Vertex_Out clippedPolygon[MAX_CLIP_POLYGON_SIZE]{};
+	float distances[MAX_CLIP_POLYGON_SIZE]{};
+
+	for (const Vector4& plane : clipPlanes)
+	{
+		bool allInside{ true };
+		bool allOutside{ true };
+		for (int index{}; index < polygonSize; ++index)
+		{
+			distances[index] = Vector4::Dot(plane, pPolygon[index].position);
+			allInside &= (distances[index] >= 0.f);
+			allOutside &= (distances[index] < 0.f);
+		}
+
+		//Only clip against the planes the polygon actually crosses
+		if (allInside)
+		{
+			continue;
+		}
+		if (allOutside)
+		{
+			return 0;
+		}
+
+		//Sutherland-Hodgman: keep inside vertices and add the crossing points
+		int clippedSize{};
+		for (int index{}; index < polygonSize; ++index)
+		{
+			const int nextIndex{ (index + 1) % polygonSize };
+
+			if (distances[index] >= 0.f)
+			{
+				clippedPolygon[clippedSize++] = pPolygon[index];
+			}
+
+			if ((distances[index] >= 0.f) != (distances[nextIndex] >= 0.f))
+			{
+				const float factor{ distances[index] / (distances[index] - distances[nextIndex]) };
+				clippedPolygon[clippedSize++] = LerpVertex(pPolygon[index], pPolygon[nextIndex], factor);
+			}
+		}
+
+		std::copy_n(clippedPolygon, clippedSize, pPolygon);
+		polygonSize = clippedSize;
+	}
+
+	return polygonSize;
+}
+
+void Renderer::BinTriangle(uint32_t triangleIndex)
+{
+	const TriangleBoundingBox& boundingBox{ m_PrimitiveAssembler.GetTriangles()[triangleIndex].boundingBox };
+
+	//Triangle is completely off screen
+	if (boundingBox.minX >= boundingBox.maxX || boundingBox.minY >= boundingBox.maxY)
+	{
+		return;
+	}
+
+	//Add the triangle to every tile its bounding box touches
+	const int tileCountX{ (m_Width + TILE_SIZE - 1) / TILE_SIZE };
+	for (int tileY{ boundingBox.minY / TILE_SIZE }; tileY <= (boundingBox.maxY - 1) / TILE_SIZE; ++tileY)
+	{
+		for (int tileX{ boundingBox.minX / TILE_SIZE }; tileX <= (boundingBox.maxX - 1) / TILE_SIZE; ++tileX)
+		{
+			m_Tiles[tileX + (tileY * tileCountX)].triangleIndices.push_back(triangleIndex);
+		}
+	}
+}
+
+void Renderer::SetupTriangle(Triangle& triangle) const
+{
+	const Mesh& mesh{ m_Meshes[triangle.meshIndex] };
+
+	const Vector4 position0{ mesh.vertices_out.GetPosition(triangle.vertex0) };
+	const Vector4 position1{ mesh.vertices_out.GetPosition(triangle.vertex1) };
+	const Vector4 position2{ mesh.vertices_out.GetPosition(triangle.vertex2) };
+
+	const Vector2 v0{ position0.x, position0.y };
+	const Vector2 v1{ position1.x, position1.y };
+	const Vector2 v2{ position2.x, position2.y };
+
+	//The edge functions are divided by twice the signed area so they directly give the barycentric weights
+	//The assembler already dropped zero-area triangles
+	const float inverseDoubleArea{ 1.f / triangle.doubleArea };
+
+	triangle.edgeFunctions[0] = EdgeFunction::Create(v1, v2, inverseDoubleArea);
+	triangle.edgeFunctions[1] = EdgeFunction::Create(v2, v0, inverseDoubleArea);
+	triangle.edgeFunctions[2] = EdgeFunction::Create(v0, v1, inverseDoubleArea);
+
+	//The interpolated depth never leaves the range of the vertex depths (w holds 1 / depth)
+	triangle.minDepth = 1.f / std::max(std::max(position0.w, position1.w), position2.w);
+
+	//Create bounding box
+	TriangleBoundingBox& boundingBox{ triangle.boundingBox };
+	boundingBox.minX = static_cast<int>(std::max(std::min(std::min(v0.x, v1.x), v2.x), 0.f));
+	boundingBox.minY = static_cast<int>(std::max(std::min(std::min(v0.y, v1.y), v2.y), 0.f));
+	boundingBox.maxX = static_cast<int>(std::ceil(std::min(std::max(std::max(v0.x, v1.x), v2.x), static_cast<float>(m_Width))));
+	boundingBox.maxY = static_cast<int>(std::ceil(std::min(std::max(std::max(v0.y, v1.y), v2.y), static_cast<float>(m_Height))));
+}
+
+void Renderer::ClearTile(const Tile& tile)
+{
+	const int tileWidth{ tile.boundingBox.maxX - tile.boundingBox.minX };
+
+	for (int py{ tile.boundingBox.minY }; py < tile.boundingBox.maxY; ++py)
+	{
+		const int rowStart{ tile.boundingBox.minX + (py * m_Width) };
+
+		std::fill_n(m_pBackBufferPixels + rowStart, tileWidth, m_ClearPixel);
+		std::fill_n(m_pDepthBufferPixels + rowStart, tileWidth, INFINITY);
+
+		if (m_DeferredShadingOn)
+		{
+			std::fill_n(m_pVisibilityBufferPixels + rowStart, tileWidth, INVALID_TRIANGLE_INDEX);
+		}
+
+		if (m_pPixelKernels->overdrawView)
+		{
+			std::fill_n(m_pOverdrawPixels + rowStart, tileWidth, 0u);
+		}
+	}
+
+	//Tiles are a whole number of blocks, so the tile owns these blocks
+	const int blockCountX{ (m_Width + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE };
+	const int minBlockX{ tile.boundingBox.minX / HIZ_BLOCK_SIZE };
+	const int maxBlockX{ (tile.boundingBox.maxX - 1) / HIZ_BLOCK_SIZE };
+	for (int blockY{ tile.boundingBox.minY / HIZ_BLOCK_SIZE }; blockY <= (tile.boundingBox.maxY - 1) / HIZ_BLOCK_SIZE; ++blockY)
+	{
+		std::fill_n(m_pHiZMaxDepth + minBlockX + (blockY * blockCountX), maxBlockX - minBlockX + 1, INFINITY);
+	}
+}
+
+void Renderer::RenderTile(Tile& tile)
+{
+	tile.trianglesCulledHiZ = 0;
+	tile.trianglesRasterized = 0;
+	tile.pixelsTested = 0;
+	tile.pixelsPassedDepth = 0;
+	tile.pixelsShaded = 0;
+
+	//Clearing here keeps the tile's buffers in cache for the triangles that follow
+	{
+		PROFILE_ZONE("ClearTile");
+		ClearTile(tile);
+	}
+
+	//Forward shading happens while rasterizing, so this zone includes PixelShading unless shading is deferred
+	{
+		PROFILE_ZONE("RasterizeTile");
+		for (const uint32_t triangleIndex : tile.triangleIndices)
+		{
+			const Triangle& triangle{ m_PrimitiveAssembler.GetTriangles()[triangleIndex] };
+
+			//The whole triangle is behind everything already drawn in this tile
+			if (triangle.minDepth > tile.maxDepth)
+			{
+				++tile.trianglesCulledHiZ;
+				continue;
+			}
+
+			++tile.trianglesRasterized;
+
+			//Only rescan the blocks when a block that held the tile's farthest depth moved closer
+			if (RasterizeTriangle(triangleIndex, tile))
+			{
+				UpdateTileDepth(tile);
+			}
+		}
+	}
+
+	//Overdraw turns the counts into colors, deferred shades every visible pixel of the tile exactly once
+	if (m_pPixelKernels->overdrawView)
+	{
+		PROFILE_ZONE("ResolveTile");
+		ResolveOverdrawTile(tile);
+	}
+	else if (m_DeferredShadingOn)
+	{
+		PROFILE_ZONE("ResolveTile");
+		(this->*m_pPixelKernels->pResolveTile)(tile);
+	}
+}
+
+bool Renderer::RasterizeTriangle(uint32_t triangleIndex, Tile& tile)
+{
+	const Triangle& triangle{ m_PrimitiveAssembler.GetTriangles()[triangleIndex] };
+
+
+	//Only walk the part of the bounding box that lies inside this tile
+	const int minX{ std::max(triangle.boundingBox.minX, tile.boundingBox.minX) };
+	const int minY{ std::max(triangle.boundingBox.minY, tile.boundingBox.minY) };
+	const int maxX{ std::min(triangle.boundingBox.maxX, tile.boundingBox.maxX) };
+	const int maxY{ std::min(triangle.boundingBox.maxY, tile.boundingBox.maxY) };
+
+	const int blockCountX{ (m_Width + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE };
+	bool tileDepthChanged{ false };
+
+	//Walk the overlap in 8x8 blocks, aligned to the hierarchical depth buffer
+	for (int blockY{ minY / HIZ_BLOCK_SIZE }; blockY <= (maxY - 1) / HIZ_BLOCK_SIZE; ++blockY)
+	{
+		for (int blockX{ minX / HIZ_BLOCK_SIZE }; blockX <= (maxX - 1) / HIZ_BLOCK_SIZE; ++blockX)
+		{
+			const int blockIndex{ blockX + (blockY * blockCountX) };
+
+			//Every pixel in this block is closer than the nearest point of the triangle
+			if (triangle.minDepth > m_pHiZMaxDepth[blockIndex])
+			{
+				continue;
+			}
+
+			TriangleBoundingBox pixelBox{};
+			pixelBox.minX = std::max(blockX * HIZ_BLOCK_SIZE, minX);
+			pixelBox.minY = std::max(blockY * HIZ_BLOCK_SIZE, minY);
+			pixelBox.maxX = std::min((blockX + 1) * HIZ_BLOCK_SIZE, maxX);
+			pixelBox.maxY = std::min((blockY + 1) * HIZ_BLOCK_SIZE, maxY);
+
+			bool blockWritten{};
+#ifdef SIMD_RASTERIZATION
+			if (m_SIMDRasterizationOn)
+			{
+				blockWritten = (this->*m_pPixelKernels->pRasterizeBlockSIMD)(triangleIndex, pixelBox, tile);
+			}
+			else
+#endif
+			{
+				blockWritten = (this->*m_pPixelKernels->pRasterizeBlockScalar)(triangleIndex, pixelBox, tile);
+			}
+
+			if (blockWritten)
+			{
+				const float previousMaxDepth{ m_pHiZMaxDepth[blockIndex] };
+				UpdateBlockDepth(blockX, blockY);
+
+				tileDepthChanged |= (previousMaxDepth == tile.maxDepth) && (m_pHiZMaxDepth[blockIndex] != previousMaxDepth);
+			}
+		}
+	}
+
+	return tileDepthChanged;
+}
+
+template<typename State>
+bool Renderer::RasterizeBlockScalar(uint32_t triangleIndex, const TriangleBoundingBox& pixelBox, Tile& tile)
+{
+	const Triangle& triangle{ m_PrimitiveAssembler.GetTriangles()[triangleIndex] };
+	const Mesh& mesh{ m_Meshes[triangle.meshIndex] };
+	const float depthV0{ mesh.vertices_out.positionW[triangle.vertex0] };
+	const float depthV1{ mesh.vertices_out.positionW[triangle.vertex1] };
+	const float depthV2{ mesh.vertices_out.positionW[triangle.vertex2] };
+
+	const EdgeFunction& edge0{ triangle.edgeFunctions[0] };
+	const EdgeFunction& edge1{ triangle.edgeFunctions[1] };
+	const EdgeFunction& edge2{ triangle.edgeFunctions[2] };
+
+	//Edge functions are stepped from the first pixel center of the triangle's bounding box
+	const int originX{ triangle.boundingBox.minX };
+	const int originY{ triangle.boundingBox.minY };
+	const Vector2 origin{ originX + 0.5f, originY + 0.5f };
+	const float originWeightV0{ edge0.Evaluate(origin) };
+	const float originWeightV1{ edge1.Evaluate(origin) };
+	const float originWeightV2{ edge2.Evaluate(origin) };
+
+	bool depthWritten{ false };
+
+	//Counted locally, the tile is only touched once per block
+	uint32_t pixelsTested{};
+	uint32_t pixelsPassedDepth{};
+
+	//Do pixel loop
+	for (int py{ pixelBox.minY }; py < pixelBox.maxY; ++py)
+	{
+		const float offsetY{ static_cast<float>(py - originY) };
+		const float rowWeightV0{ originWeightV0 + (edge0.b * offsetY) };
+		const float rowWeightV1{ originWeightV1 + (edge1.b * offsetY) };
+		const float rowWeightV2{ originWeightV2 + (edge2.b * offsetY) };
+
+		for (int px{ pixelBox.minX }; px < pixelBox.maxX; ++px)
+		{
+			//Step from the row start so every pixel sees the same rounding as a SIMD lane
+			const float offsetX{ static_cast<float>(px - originX) };
+			const float weightV0{ rowWeightV0 + (edge0.a * offsetX) };
+			const float weightV1{ rowWeightV1 + (edge1.a * offsetX) };
+			const float weightV2{ rowWeightV2 + (edge2.a * offsetX) };
+
+			//If pixel not in triangle skip to next pixel
+			if (weightV0 < 0 || weightV1 < 0 || weightV2 < 0)
+			{
+				continue;
+			}
+
+			++pixelsTested;
+			if constexpr (State::overdrawView)
+			{
+				++m_pOverdrawPixels[px + (py * m_Width)];
+			}
+
+			//Calculate the pixel depth
+			const float pixelDepth{ 1.f / ((weightV0 * depthV0) + (weightV1 * depthV1) + (weightV2 * depthV2)) };
+
+			//If the z point is not closer in this triangle check the next triangle
+			if (!(pixelDepth <= m_pDepthBufferPixels[px + (py * m_Width)]))
+			{
+				continue;
+			}
+
+			//Set z buffer to closer point
+			m_pDepthBufferPixels[px + (py * m_Width)] = pixelDepth;
+			depthWritten = true;
+			++pixelsPassedDepth;
+
+			if constexpr (State::overdrawView)
+			{
+				continue;
+			}
+
+			if (m_DeferredShadingOn)
+			{
+				m_pVisibilityBufferPixels[px + (py * m_Width)] = triangleIndex;
+				continue;
+			}
+
+			m_pBackBufferPixels[px + (py * m_Width)] = m_FramebufferWriter.Pack(ShadePixel<State>(mesh, triangle, px, py, weightV0, weightV1, weightV2, pixelDepth));
+		}
+	}
+
+	tile.pixelsTested += pixelsTested;
+	tile.pixelsPassedDepth += pixelsPassedDepth;
+	if constexpr (State::callsPixelShading)
+	{
+		if (!m_DeferredShadingOn)
+		{
+			tile.pixelsShaded += pixelsPassedDepth;
+		}
+	}
+
+	return depthWritten;
+}
+
+#ifdef SIMD_RASTERIZATION
+template<typename State>
+bool Renderer::RasterizeBlockSIMD(uint32_t triangleIndex, const TriangleBoundingBox& pixelBox, Tile& tile)
+{
+	constexpr int spanWidth{ HIZ_BLOCK_SIZE };
+
+	const Triangle& triangle{ m_PrimitiveAssembler.GetTriangles()[triangleIndex] };
+
+	const Mesh& mesh{ m_Meshes[triangle.meshIndex] };
+	const __m256 depthV0{ _mm256_set1_ps(mesh.vertices_out.positionW[triangle.vertex0]) };
+	const __m256 depthV1{ _mm256_set1_ps(mesh.vertices_out.positionW[triangle.vertex1]) };
+	const __m256 depthV2{ _mm256_set1_ps(mesh.vertices_out.positionW[triangle.vertex2]) };
+
+	const EdgeFunction& edge0{ triangle.edgeFunctions[0] };
+	const EdgeFunction& edge1{ triangle.edgeFunctions[1] };
+	const EdgeFunction& edge2{ triangle.edgeFunctions[2] };
+
+	const __m256 stepXV0{ _mm256_set1_ps(edge0.a) };
+	const __m256 stepXV1{ _mm256_set1_ps(edge1.a) };
+	const __m256 stepXV2{ _mm256_set1_ps(edge2.a) };
+
+	const __m256 zero{ _mm256_setzero_ps() };
+	const __m256 one{ _mm256_set1_ps(1.f) };
+
+	//Edge functions are stepped from the first pixel center of the triangle's bounding box
+	const int originX{ triangle.boundingBox.minX };
+	const int originY{ triangle.boundingBox.minY };
+	const Vector2 origin{ originX + 0.5f, originY + 0.5f };
+	const float originWeightV0{ edge0.Evaluate(origin) };
+	const float originWeightV1{ edge1.Evaluate(origin) };
+	const float originWeightV2{ edge2.Evaluate(origin) };
+
+	//The span always starts at the block's left edge, lanes outside the pixel box are masked off
+	const int spanX{ pixelBox.minX - (pixelBox.minX % spanWidth) };
+	const __m256i laneX{ _mm256_add_epi32(_mm256_set1_epi32(spanX), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)) };
+	const __m256i validLanes
+	{
+		_mm256_andnot_si256(
+			_mm256_cmpgt_epi32(_mm256_set1_epi32(pixelBox.minX), laneX),
+			_mm256_cmpgt_epi32(_mm256_set1_epi32(pixelBox.maxX), laneX))
+	};
+	const __m256 offsetX{ _mm256_cvtepi32_ps(_mm256_sub_epi32(laneX, _mm256_set1_epi32(originX))) };
+
+	alignas(32) float weightsV0[spanWidth];
+	alignas(32) float weightsV1[spanWidth];
+	alignas(32) float weightsV2[spanWidth];
+	alignas(32) float pixelDepths[spanWidth];
+
+	//Shaded colors of the span, lanes that were not shaded are masked off when storing
+	alignas(32) float reds[spanWidth]{};
+	alignas(32) float greens[spanWidth]{};
+	alignas(32) float blues[spanWidth]{};
+
+	bool depthWritten{ false };
+
+	//Counted locally, the tile is only touched once per block
+	uint32_t pixelsTested{};
+	uint32_t pixelsPassedDepth{};
+
+	//Do pixel loop, one row of the block at a time
+	for (int py{ pixelBox.minY }; py < pixelBox.maxY; ++py)
+	{
+		const float offsetY{ static_cast<float>(py - originY) };
+		const __m256 rowV0{ _mm256_set1_ps(originWeightV0 + (edge0.b * offsetY)) };
+		const __m256 rowV1{ _mm256_set1_ps(originWeightV1 + (edge1.b * offsetY)) };
+		const __m256 rowV2{ _mm256_set1_ps(originWeightV2 + (edge2.b * offsetY)) };
+
+		const __m256 weightV0{ _mm256_add_ps(rowV0, _mm256_mul_ps(stepXV0, offsetX)) };
+		const __m256 weightV1{ _mm256_add_ps(rowV1, _mm256_mul_ps(stepXV1, offsetX)) };
+		const __m256 weightV2{ _mm256_add_ps(rowV2, _mm256_mul_ps(stepXV2, offsetX)) };
+
+		//Coverage: not less than zero for all three weights, same test as the scalar path
+		__m256 coverage{ _mm256_castsi256_ps(validLanes) };
+		coverage = _mm256_and_ps(coverage, _mm256_cmp_ps(weightV0, zero, _CMP_NLT_UQ));
+		coverage = _mm256_and_ps(coverage, _mm256_cmp_ps(weightV1, zero, _CMP_NLT_UQ));
+		coverage = _mm256_and_ps(coverage, _mm256_cmp_ps(weightV2, zero, _CMP_NLT_UQ));
+
+		if (_mm256_testz_ps(coverage, coverage))
+		{
+			continue;
+		}
+
+		pixelsTested += std::popcount(static_cast<unsigned int>(_mm256_movemask_ps(coverage)));
+		if constexpr (State::overdrawView)
+		{
+			//Covered lanes are all ones, subtracting them adds one
+			int* pOverdraw{ reinterpret_cast<int*>(m_pOverdrawPixels + spanX + (py * m_Width)) };
+			const __m256i coverageLanes{ _mm256_castps_si256(coverage) };
+			_mm256_maskstore_epi32(pOverdraw, coverageLanes, _mm256_sub_epi32(_mm256_maskload_epi32(pOverdraw, coverageLanes), coverageLanes));
+		}
+
+		//Calculate the pixel depths
+		const __m256 interpolatedDepth
+		{
+			_mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(weightV0, depthV0), _mm256_mul_ps(weightV1, depthV1)),
+				_mm256_mul_ps(weightV2, depthV2))
+		};
+		const __m256 pixelDepth{ _mm256_div_ps(one, interpolatedDepth) };
+
+		//Depth test against the buffer, never touching memory outside the pixel box
+		float* pDepth{ m_pDepthBufferPixels + spanX + (py * m_Width) };
+		const __m256 bufferDepth{ _mm256_maskload_ps(pDepth, validLanes) };
+		coverage = _mm256_and_ps(coverage, _mm256_cmp_ps(pixelDepth, bufferDepth, _CMP_LE_OQ));
+
+		int coverageMask{ _mm256_movemask_ps(coverage) };
+		if (coverageMask == 0)
+		{
+			continue;
+		}
+
+		//Set z buffer to closer points
+		_mm256_maskstore_ps(pDepth, _mm256_castps_si256(coverage), pixelDepth);
+		depthWritten = true;
+		pixelsPassedDepth += std::popcount(static_cast<unsigned int>(coverageMask));
 
-	//Create Buffers
-	m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
-	m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
-	m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
+		if constexpr (State::overdrawView)
+		{
+			continue;
+		}
+
+		if (m_DeferredShadingOn)
+		{
+			int* pVisibility{ reinterpret_cast<int*>(m_pVisibilityBufferPixels + spanX + (py * m_Width)) };
+			_mm256_maskstore_epi32(pVisibility, _mm256_castps_si256(coverage), _mm256_set1_epi32(static_cast<int>(triangleIndex)));
+			continue;
+		}
 
-	m_pDepthBufferPixels = new float[m_Width * m_Height];
+		_mm256_store_ps(weightsV0, weightV0);
+		_mm256_store_ps(weightsV1, weightV1);
+		_mm256_store_ps(weightsV2, weightV2);
+		_mm256_store_ps(pixelDepths, pixelDepth);
 
-	//Initialize Camera
-	m_Camera.Initialize(static_cast<float>(m_Width) / m_Height, 45.f, { .0f,.5f, -64.f });
+		//Only the pixels that survived coverage and depth are interpolated, then they are shaded together
+		Vertex_Out spanPixels[spanWidth];
+		int spanLanes[spanWidth];
+		int spanPixelCount{};
+		while (coverageMask != 0)
+		{
+			const int lane{ std::countr_zero(static_cast<unsigned int>(coverageMask)) };
+			coverageMask &= coverageMask - 1;
 
-	m_pTextureDiffuse = Texture::LoadFromFile("Resources/vehicle_diffuse.png");
-	m_pTextureGloss = Texture::LoadFromFile("Resources/vehicle_gloss.png");
-	m_pTextureNormal = Texture::LoadFromFile("Resources/vehicle_normal.png");
-	m_pTextureSpecular = Texture::LoadFromFile("Resources/vehicle_specular.png");
+			spanPixels[spanPixelCount] = InterpolatePixel<State>(mesh, triangle, spanX + lane, py, weightsV0[lane], weightsV1[lane], weightsV2[lane], pixelDepths[lane]);
+			spanLanes[spanPixelCount] = lane;
+			++spanPixelCount;
+		}
 
-	m_Meshes.push_back(Mesh{});
-	m_Meshes[0].primitiveTopology = PrimitiveTopology::TriangleList;
-	Utils::ParseOBJ("Resources/vehicle.obj", m_Meshes[0].vertices, m_Meshes[0].indices);
-	m_Meshes[0].worldMatrix =
+		ColorRGB spanColors[spanWidth];
+		ShadePixels<State>(spanPixels, spanPixelCount, spanColors);
+		for (int index{}; index < spanPixelCount; ++index)
+		{
+			reds[spanLanes[index]] = spanColors[index].r;
+			greens[spanLanes[index]] = spanColors[index].g;
+			blues[spanLanes[index]] = spanColors[index].b;
+		}
+
+		//Pack and store the whole span at once
+		int* pPixels{ reinterpret_cast<int*>(m_pBackBufferPixels + spanX + (py * m_Width)) };
+		_mm256_maskstore_epi32(pPixels, _mm256_castps_si256(coverage), m_FramebufferWriter.Pack(_mm256_load_ps(reds), _mm256_load_ps(greens), _mm256_load_ps(blues)));
+	}
+
+	tile.pixelsTested += pixelsTested;
+	tile.pixelsPassedDepth += pixelsPassedDepth;
+	if constexpr (State::callsPixelShading)
 	{
-		Matrix{}
-	};
-}
+		if (!m_DeferredShadingOn)
+		{
+			tile.pixelsShaded += pixelsPassedDepth;
+		}
+	}
 
-Renderer::~Renderer()
-{
-	delete[] m_pDepthBufferPixels;
+	return depthWritten;
 }
+#endif
 
-void Renderer::Update(Timer* pTimer)
+void Renderer::UpdateBlockDepth(int blockX, int blockY)
 {
-	m_Camera.Update(pTimer);
-	if(m_RotatingOn)
+	const int minX{ blockX * HIZ_BLOCK_SIZE };
+	const int minY{ blockY * HIZ_BLOCK_SIZE };
+	const int maxX{ std::min(minX + HIZ_BLOCK_SIZE, m_Width) };
+	const int maxY{ std::min(minY + HIZ_BLOCK_SIZE, m_Height) };
+
+	float maxDepth{ 0.f };
+
+#ifdef SIMD_RASTERIZATION
+	//Full-width blocks: one row of the block is one AVX register
+	if (maxX - minX == HIZ_BLOCK_SIZE)
+	{
+		__m256 rowMax{ _mm256_setzero_ps() };
+		for (int py{ minY }; py < maxY; ++py)
+		{
+			rowMax = _mm256_max_ps(rowMax, _mm256_loadu_ps(m_pDepthBufferPixels + minX + (py * m_Width)));
+		}
+
+		__m128 halfMax{ _mm_max_ps(_mm256_castps256_ps128(rowMax), _mm256_extractf128_ps(rowMax, 1)) };
+		halfMax = _mm_max_ps(halfMax, _mm_movehl_ps(halfMax, halfMax));
+		halfMax = _mm_max_ss(halfMax, _mm_shuffle_ps(halfMax, halfMax, 1));
+		maxDepth = _mm_cvtss_f32(halfMax);
+	}
+	else
+#endif
 	{
-		m_Meshes[0].worldMatrix = Matrix::CreateRotationY(pTimer->GetTotal() / 2) * Matrix::CreateTranslation(0, 0, -40.f);
+		for (int py{ minY }; py < maxY; ++py)
+		{
+			for (int px{ minX }; px < maxX; ++px)
+			{
+				maxDepth = std::max(maxDepth, m_pDepthBufferPixels[px + (py * m_Width)]);
+			}
+		}
 	}
+
+	const int blockCountX{ (m_Width + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE };
+	m_pHiZMaxDepth[blockX + (blockY * blockCountX)] = maxDepth;
 }
 
-void Renderer::Render()
+void Renderer::UpdateTileDepth(Tile& tile)
 {
-	//@START
-	//Lock BackBuffer
-	SDL_FillRect(m_pBackBuffer, NULL, SDL_MapRGB(m_pBackBuffer->format, Uint8{ 100 }, Uint8{ 100 }, Uint8{ 100 }));
-	SDL_LockSurface(m_pBackBuffer);
+	const int blockCountX{ (m_Width + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE };
 
-	for(int index{}; index < m_Width * m_Height; ++index)
+	float maxDepth{ 0.f };
+	for (int blockY{ tile.boundingBox.minY / HIZ_BLOCK_SIZE }; blockY <= (tile.boundingBox.maxY - 1) / HIZ_BLOCK_SIZE; ++blockY)
 	{
-		m_pDepthBufferPixels[index] = INFINITY;
+		for (int blockX{ tile.boundingBox.minX / HIZ_BLOCK_SIZE }; blockX <= (tile.boundingBox.maxX - 1) / HIZ_BLOCK_SIZE; ++blockX)
+		{
+			maxDepth = std::max(maxDepth, m_pHiZMaxDepth[blockX + (blockY * blockCountX)]);
+		}
 	}
 
-	VertexTransformationFunction(m_Meshes);
+	tile.maxDepth = maxDepth;
+}
 
-	//RENDER LOGIC
-	for (auto& mesh : m_Meshes)
+template<typename State>
+void Renderer::ResolveTile(Tile& tile)
+{
+	const auto interpolatePixel = [this](int px, int py, uint32_t triangleIndex)
+		{
+			const Triangle& triangle{ m_PrimitiveAssembler.GetTriangles()[triangleIndex] };
+
+			//Reconstruct the weights exactly like the raster loop did
+			const EdgeFunction& edge0{ triangle.edgeFunctions[0] };
+			const EdgeFunction& edge1{ triangle.edgeFunctions[1] };
+			const EdgeFunction& edge2{ triangle.edgeFunctions[2] };
+
+			const Vector2 origin{ triangle.boundingBox.minX + 0.5f, triangle.boundingBox.minY + 0.5f };
+			const float offsetX{ static_cast<float>(px - triangle.boundingBox.minX) };
+			const float offsetY{ static_cast<float>(py - triangle.boundingBox.minY) };
+
+			const float weightV0{ (edge0.Evaluate(origin) + (edge0.b * offsetY)) + (edge0.a * offsetX) };
+			const float weightV1{ (edge1.Evaluate(origin) + (edge1.b * offsetY)) + (edge1.a * offsetX) };
+			const float weightV2{ (edge2.Evaluate(origin) + (edge2.b * offsetY)) + (edge2.a * offsetX) };
+
+			return InterpolatePixel<State>(m_Meshes[triangle.meshIndex], triangle, px, py, weightV0, weightV1, weightV2, m_pDepthBufferPixels[px + (py * m_Width)]);
+		};
+
+	uint32_t shadedPixels{};
+
+#ifdef SIMD_RASTERIZATION
+	//Interpolated pixels of a span, shaded together, set up once per tile instead of once per row
+	Vertex_Out spanPixels[SHADING_SPAN_WIDTH];
+	int spanLanes[SHADING_SPAN_WIDTH];
+	ColorRGB spanColors[SHADING_SPAN_WIDTH];
+#endif
+
+	for (int py{ tile.boundingBox.minY }; py < tile.boundingBox.maxY; ++py)
 	{
-		//Check all triangles
-		for (int triangleIndex{}; triangleIndex < static_cast<int>(mesh.indices.size() - 2); ++triangleIndex)
+#ifdef SIMD_RASTERIZATION
+		if (m_SIMDRasterizationOn)
 		{
-			uint32_t vertex0{ mesh.indices[triangleIndex] };
-			uint32_t vertex1{ mesh.indices[triangleIndex + 1] };
-			uint32_t vertex2{ mesh.indices[triangleIndex + 2] };
+			constexpr int spanWidth{ SHADING_SPAN_WIDTH };
 
-			//Do triangleStrip
-			if (mesh.primitiveTopology == PrimitiveTopology::TriangleStrip)
+			alignas(32) float reds[spanWidth]{};
+			alignas(32) float greens[spanWidth]{};
+			alignas(32) float blues[spanWidth]{};
+
+			//Shade a span of the row, then pack and store it at once
+			for (int spanX{ tile.boundingBox.minX }; spanX < tile.boundingBox.maxX; spanX += spanWidth)
 			{
-				//Check degenerate triangles
-				if ((mesh.indices[vertex0] == mesh.indices[vertex1]) && (mesh.indices[vertex1] == mesh.indices[vertex2]))
+				alignas(32) int shadedLanes[spanWidth]{};
+				int spanPixelCount{};
+
+				for (int lane{}; lane < spanWidth && spanX + lane < tile.boundingBox.maxX; ++lane)
+				{
+					const uint32_t triangleIndex{ m_pVisibilityBufferPixels[spanX + lane + (py * m_Width)] };
+					if (triangleIndex == INVALID_TRIANGLE_INDEX)
+					{
+						continue;
+					}
+
+					spanPixels[spanPixelCount] = interpolatePixel(spanX + lane, py, triangleIndex);
+					spanLanes[spanPixelCount] = lane;
+					++spanPixelCount;
+
+					shadedLanes[lane] = -1;
+				}
+
+				if (spanPixelCount == 0)
 				{
 					continue;
 				}
 
-				//If triangleIndex is odd, swap 2nd and 3rd element
-				if (((triangleIndex % 2) == 1))
+				ShadePixels<State>(spanPixels, spanPixelCount, spanColors);
+				shadedPixels += spanPixelCount;
+				for (int index{}; index < spanPixelCount; ++index)
 				{
-					std::swap(vertex1, vertex2);
+					reds[spanLanes[index]] = spanColors[index].r;
+					greens[spanLanes[index]] = spanColors[index].g;
+					blues[spanLanes[index]] = spanColors[index].b;
 				}
+
+				int* pPixels{ reinterpret_cast<int*>(m_pBackBufferPixels + spanX + (py * m_Width)) };
+				_mm256_maskstore_epi32(pPixels, _mm256_load_si256(reinterpret_cast<const __m256i*>(shadedLanes)),
+					m_FramebufferWriter.Pack(_mm256_load_ps(reds), _mm256_load_ps(greens), _mm256_load_ps(blues)));
 			}
-			//Do triangleList
-			else if(mesh.primitiveTopology == PrimitiveTopology::TriangleList)
+
+			continue;
+		}
+#endif
+
+		for (int px{ tile.boundingBox.minX }; px < tile.boundingBox.maxX; ++px)
+		{
+			const uint32_t triangleIndex{ m_pVisibilityBufferPixels[px + (py * m_Width)] };
+			if (triangleIndex == INVALID_TRIANGLE_INDEX)
 			{
-				triangleIndex += 2;
+				continue;
 			}
 
-			if
-				(
-					(mesh.vertices_out[vertex0].position.z < 0 || 1 < mesh.vertices_out[vertex0].position.z) ||
-					(mesh.vertices_out[vertex1].position.z < 0 || 1 < mesh.vertices_out[vertex1].position.z) ||
-					(mesh.vertices_out[vertex2].position.z < 0 || 1 < mesh.vertices_out[vertex2].position.z)
-				)
+			const Vertex_Out pixel{ interpolatePixel(px, py, triangleIndex) };
+			ColorRGB color{};
+			ShadePixels<State>(&pixel, 1, &color);
+
+			m_pBackBufferPixels[px + (py * m_Width)] = m_FramebufferWriter.Pack(color);
+			++shadedPixels;
+		}
+	}
+
+	if constexpr (State::callsPixelShading)
+	{
+		tile.pixelsShaded += shadedPixels;
+	}
+}
+
+void Renderer::ResolveOverdrawTile(const Tile& tile)
+{
+	//One covered pixel is blue, eight or more are white, untouched pixels keep the clear color
+	static const ColorRGB heatmap[]
+	{
+		{ 0.f, 0.f, 1.f },
+		{ 0.f, .5f, 1.f },
+		{ 0.f, 1.f, 1.f },
+		{ 0.f, 1.f, 0.f },
+		{ 1.f, 1.f, 0.f },
+		{ 1.f, .5f, 0.f },
+		{ 1.f, 0.f, 0.f },
+		{ 1.f, 1.f, 1.f }
+	};
+	constexpr uint32_t heatmapSize{ static_cast<uint32_t>(std::size(heatmap)) };
+
+	for (int py{ tile.boundingBox.minY }; py < tile.boundingBox.maxY; ++py)
+	{
+		for (int px{ tile.boundingBox.minX }; px < tile.boundingBox.maxX; ++px)
+		{
+			const uint32_t overdraw{ m_pOverdrawPixels[px + (py * m_Width)] };
+			if (overdraw == 0)
 			{
 				continue;
 			}
-			
-			//Create triangle vectors
-			const Vector2 v0{ mesh.vertices_out[vertex0].position.x, mesh.vertices_out[vertex0].position.y };
-			const Vector2 v1{ mesh.vertices_out[vertex1].position.x, mesh.vertices_out[vertex1].position.y };
-			const Vector2 v2{ mesh.vertices_out[vertex2].position.x, mesh.vertices_out[vertex2].position.y };
-
-			const float totalTriangleArea{ Vector2::Cross(v1 - v0, v2 - v0) / 2 };
-
-			//Create bounding box
-			const float minX =
-				std::max(std::min(std::min(v0.x, v1.x), v2.x), 0.f);
-			const float minY =
-				std::max(std::min(std::min(v0.y, v1.y), v2.y), 0.f);
-
-			const float maxX =
-				std::min(std::max(std::max(v0.x, v1.x), v2.x), static_cast<float> (m_Width));
-			const float maxY =
-				std::min(std::max(std::max(v0.y, v1.y), v2.y), static_cast<float> (m_Height));
-
-			//Do pixel loop
-			for (int px{ static_cast<int>(minX) }; px < maxX; ++px)
-			{
-				for (int py{ static_cast<int>(minY) }; py < maxY; ++py)
-				{
-					Vector2 pixel{ px + 0.5f, py + 0.5f };
 
-					float pixelDepth{};
-					/*ColorRGB pixelColor{};*/
-					Vector2 pixelUV{};
+			m_pBackBufferPixels[px + (py * m_Width)] = m_FramebufferWriter.Pack(heatmap[std::min(overdraw, heatmapSize) - 1]);
+		}
+	}
+}
 
-					//If pixel not in triangle skip to next pixel
-					const float weightV0{ (Vector2::Cross(v2 - v1, pixel - v1) / 2.f) / totalTriangleArea };
-					if (weightV0 < 0)
-					{
-						continue;
-					}
-					const float weightV1{ (Vector2::Cross(v0 - v2, pixel - v2) / 2.f) / totalTriangleArea };
-					if (weightV1 < 0)
-					{
-						continue;
-					}
-					const float weightV2{ (Vector2::Cross(v1 - v0, pixel - v0) / 2.f) / totalTriangleArea };
-					if (weightV2 < 0)
-					{
-						continue;
-					}
+template<typename State>
+ColorRGB Renderer::ShadePixel(const Mesh& mesh, const Triangle& triangle, int px, int py, float weightV0, float weightV1, float weightV2, float pixelDepth) const
+{
+	const Vertex_Out pixel{ InterpolatePixel<State>(mesh, triangle, px, py, weightV0, weightV1, weightV2, pixelDepth) };
 
-					/*pixelColor =
-						mesh.vertices[vertex0].color * weightV0 +
-						mesh.vertices[vertex1].color * weightV1 +
-						mesh.vertices[vertex2].color * weightV2;*/
-
-					//Calculate the pixel depth
-					pixelDepth = 1.f / 
-						(
-							(weightV0 * mesh.vertices_out[vertex0].position.w) + 
-							(weightV1 * mesh.vertices_out[vertex1].position.w) +
-							(weightV2 * mesh.vertices_out[vertex2].position.w)
-						);
-					const float interpolatedZ = 1.f /
-						(
-							((mesh.vertices_out[vertex0].position.z) * weightV0) +
-							((mesh.vertices_out[vertex1].position.z) * weightV1) +
-							((mesh.vertices_out[vertex2].position.z) * weightV2)
-							);
-
-					//If the z point is not closer in this triangle check the next triangle
-					if (!(pixelDepth <= m_pDepthBufferPixels[px + (py * m_Width)]))
-					{
-						continue;
-					}
+	ColorRGB finalColor{};
+	ShadePixels<State>(&pixel, 1, &finalColor);
+
+	return finalColor;
+}
 
-					//Set z buffer to closer point
-					m_pDepthBufferPixels[px + (py * m_Width)] = pixelDepth;
+template<typename State>
+Vertex_Out Renderer::InterpolatePixel(const Mesh& mesh, const Triangle& triangle, int px, int py, float weightV0, float weightV1, float weightV2, float pixelDepth) const
+{
+	Vertex_Out currentVertex{};
 
-					//Calculate the pixel UV
-					pixelUV =
-						(
-							((mesh.vertices_out[vertex0].uv * weightV0) * mesh.vertices_out[vertex0].position.w) +
-							((mesh.vertices_out[vertex1].uv * weightV1) * mesh.vertices_out[vertex1].position.w) +
-							((mesh.vertices_out[vertex2].uv * weightV2) * mesh.vertices_out[vertex2].position.w)
-						) * pixelDepth;
+	//The depth view only needs the depth
+	if constexpr (State::depthView)
+	{
+		(void)mesh;
+		(void)triangle;
+		(void)px;
+		(void)py;
+		(void)weightV0;
+		(void)weightV1;
+		(void)weightV2;
 
-					ColorRGB finalColor{};
+		currentVertex.position.w = pixelDepth;
+	}
+	else
+	{
+		const uint32_t vertex0{ triangle.vertex0 };
+		const uint32_t vertex1{ triangle.vertex1 };
+		const uint32_t vertex2{ triangle.vertex2 };
 
-					//show buffer depth with 0-1  greyscale if m_DepthBufferOn is on, otherwise show normal texture
-					if(m_DepthBufferOn)
-					{
-						pixelDepth = Lerpf(1.f, 0.995f, pixelDepth);
-						finalColor = ColorRGB(pixelDepth, pixelDepth, pixelDepth);
-					}
-					else
+		const VertexStreams& streams{ mesh.vertices_out };
+		const auto interpolate = [&](const std::vector<float>& stream)
+			{
+				return streams.Interpolate(stream, vertex0, vertex1, vertex2, weightV0, weightV1, weightV2);
+			};
+
+		const Vector2 pixel{ px + 0.5f, py + 0.5f };
+
+		const float interpolatedZ = 1.f /
+			(
+				(streams.positionZ[vertex0] * weightV0) +
+				(streams.positionZ[vertex1] * weightV1) +
+				(streams.positionZ[vertex2] * weightV2)
+			);
+
+		//Only the attributes this kernel reads were written and get interpolated
+		currentVertex.position =
+		{
+			pixel.x,
+			pixel.y,
+			interpolatedZ,
+			pixelDepth
+		};
+
+		if constexpr (State::attributes.uv)
+		{
+			//Calculate the pixel UV
+			currentVertex.uv = Vector2{ interpolate(streams.u), interpolate(streams.v) } * pixelDepth;
+
+			//Differences across the pixel's 2x2 quad, like a GPU takes them, so all four pixels pick the same mip level
+			//The edge functions are linear in screen space, so the quad corners are evaluated even where the triangle does not cover them
+			if (Texture::NeedsDerivatives(m_TextureFilter))
+			{
+				const EdgeFunction& edge0{ triangle.edgeFunctions[0] };
+				const EdgeFunction& edge1{ triangle.edgeFunctions[1] };
+				const EdgeFunction& edge2{ triangle.edgeFunctions[2] };
+
+				const auto uvAt = [&](float offsetX, float offsetY)
 					{
-						//Shading function
-						Vertex_Out currentVertex{};
-						currentVertex.uv = pixelUV;
-						currentVertex.position =
-						{
-							pixel.x,
-							pixel.y,
-							interpolatedZ,
-							pixelDepth
-						};
-
-						currentVertex.normal =
-							(
-								((mesh.vertices_out[vertex0].normal * weightV0) * mesh.vertices_out[vertex0].position.w) +
-								((mesh.vertices_out[vertex1].normal * weightV1) * mesh.vertices_out[vertex1].position.w) +
-								((mesh.vertices_out[vertex2].normal * weightV2) * mesh.vertices_out[vertex2].position.w)
-							);
-						currentVertex.normal.Normalize();
-
-						currentVertex.tangent =
-							(
-								((mesh.vertices_out[vertex0].tangent * weightV0) * mesh.vertices_out[vertex0].position.w) +
-								((mesh.vertices_out[vertex1].tangent * weightV1) * mesh.vertices_out[vertex1].position.w) +
-								((mesh.vertices_out[vertex2].tangent * weightV2) * mesh.vertices_out[vertex2].position.w)
-							);
-						currentVertex.tangent.Normalize();
-
-						currentVertex.viewDirection = 
-							(
-								((mesh.vertices_out[vertex0].viewDirection * weightV0) * mesh.vertices_out[vertex0].position.w) +
-								((mesh.vertices_out[vertex1].viewDirection * weightV1) * mesh.vertices_out[vertex1].position.w) +
-								((mesh.vertices_out[vertex2].viewDirection * weightV2) * mesh.vertices_out[vertex2].position.w)
-							);
-
-						finalColor = PixelShading(currentVertex);
-					}
+						const float offsetWeightV0{ weightV0 + (edge0.a * offsetX) + (edge0.b * offsetY) };
+						const float offsetWeightV1{ weightV1 + (edge1.a * offsetX) + (edge1.b * offsetY) };
+						const float offsetWeightV2{ weightV2 + (edge2.a * offsetX) + (edge2.b * offsetY) };
+						const float offsetDepth{ 1.f / ((offsetWeightV0 * streams.positionW[vertex0]) + (offsetWeightV1 * streams.positionW[vertex1]) + (offsetWeightV2 * streams.positionW[vertex2])) };
 
-					//Update Color in Buffer
-					finalColor.MaxToOne();
+						return Vector2
+						{
+							streams.Interpolate(streams.u, vertex0, vertex1, vertex2, offsetWeightV0, offsetWeightV1, offsetWeightV2),
+							streams.Interpolate(streams.v, vertex0, vertex1, vertex2, offsetWeightV0, offsetWeightV1, offsetWeightV2)
+						} * offsetDepth;
+					};
 
-					m_pBackBufferPixels[px + (py * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-						static_cast<uint8_t>(finalColor.r * 255),
-						static_cast<uint8_t>(finalColor.g * 255),
-						static_cast<uint8_t>(finalColor.b * 255));
-				}
+				const float quadX{ -static_cast<float>(px & 1) };
+				const float quadY{ -static_cast<float>(py & 1) };
+				const Vector2 quadUV{ uvAt(quadX, quadY) };
+				currentVertex.uvDerivativeX = uvAt(quadX + 1.f, quadY) - quadUV;
+				currentVertex.uvDerivativeY = uvAt(quadX, quadY + 1.f) - quadUV;
 			}
 		}
+
+		if constexpr (State::attributes.normal)
+		{
+			currentVertex.normal = { interpolate(streams.normalX), interpolate(streams.normalY), interpolate(streams.normalZ) };
+			currentVertex.normal.Normalize();
+		}
+
+		if constexpr (State::attributes.tangent)
+		{
+			currentVertex.tangent = { interpolate(streams.tangentX), interpolate(streams.tangentY), interpolate(streams.tangentZ) };
+			currentVertex.tangent.Normalize();
+		}
+
+		if constexpr (State::attributes.viewDirection)
+		{
+			currentVertex.viewDirection = { interpolate(streams.viewDirectionX), interpolate(streams.viewDirectionY), interpolate(streams.viewDirectionZ) };
+		}
 	}
 
-	//@END
-	//Update SDL Surface
-	SDL_UnlockSurface(m_pBackBuffer);
-	SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
-	SDL_UpdateWindowSurface(m_pWindow);
+	return currentVertex;
+}
+
+template<typename State>
+void Renderer::ShadePixels(const Vertex_Out* pPixels, int count, ColorRGB* pColors) const
+{
+	//show buffer depth with 0-1  greyscale if m_DepthBufferOn is on, otherwise show normal texture
+	if constexpr (State::depthView)
+	{
+		for (int index{}; index < count; ++index)
+		{
+			const float pixelDepth{ Lerpf(1.f, 0.995f, pPixels[index].position.w) };
+			pColors[index] = ColorRGB(pixelDepth, pixelDepth, pixelDepth);
+		}
+	}
+	else
+	{
+		SpanTextureSamples samples{};
+		SampleTextures<State>(pPixels, count, samples);
+
+		for (int index{}; index < count; ++index)
+		{
+			pColors[index] = PixelShading<State>(pPixels[index], samples, index);
+		}
+	}
+
+	//The framebuffer writer expects colors in [0, 1]
+	for (int index{}; index < count; ++index)
+	{
+		pColors[index].MaxToOne();
+	}
+}
+
+template<typename State>
+void Renderer::SampleTextures(const Vertex_Out* pPixels, int count, SpanTextureSamples& samples) const
+{
+	constexpr bool needsNormalMap{ State::needsNormal && State::normalMapping };
+
+	//Bilinear ignores the derivatives, so the span is filtered in one batched call per texture
+	if (m_TextureFilter == Texture::Filter::bilinear)
+	{
+		alignas(32) float us[SHADING_SPAN_WIDTH];
+		alignas(32) float vs[SHADING_SPAN_WIDTH];
+		for (int index{}; index < count; ++index)
+		{
+			us[index] = pPixels[index].uv.x;
+			vs[index] = pPixels[index].uv.y;
+		}
+
+		if constexpr (State::needsDiffuse)
+			m_pTextureDiffuse->SampleBilinear(us, vs, count, samples.diffuse);
+		if constexpr (needsNormalMap)
+			m_pTextureNormal->SampleBilinear(us, vs, count, samples.normal);
+		if constexpr (State::needsSpecular)
+		{
+			m_pTextureGloss->SampleBilinear(us, vs, count, samples.gloss);
+			m_pTextureSpecular->SampleBilinear(us, vs, count, samples.specular);
+		}
+
+		return;
+	}
+
+	for (int index{}; index < count; ++index)
+	{
+		const Vertex_Out& v{ pPixels[index] };
+
+		if constexpr (State::needsDiffuse)
+			samples.diffuse[index] = m_pTextureDiffuse->Sample(v.uv, v.uvDerivativeX, v.uvDerivativeY, m_TextureFilter);
+		if constexpr (needsNormalMap)
+			samples.normal[index] = m_pTextureNormal->Sample(v.uv, v.uvDerivativeX, v.uvDerivativeY, m_TextureFilter);
+		if constexpr (State::needsSpecular)
+		{
+			samples.gloss[index] = m_pTextureGloss->Sample(v.uv, v.uvDerivativeX, v.uvDerivativeY, m_TextureFilter);
+			samples.specular[index] = m_pTextureSpecular->Sample(v.uv, v.uvDerivativeX, v.uvDerivativeY, m_TextureFilter);
+		}
+	}
 }
 
 void Renderer::VertexTransformationFunction(Mesh& mesh) const
 {
 	//Todo > W1 Projection Stage
-	mesh.vertices_out.clear();
+	VertexStreams& streams{ mesh.vertices_out };
+	streams.attributes = m_pPixelKernels->attributes;
+
+	//Resizing keeps the capacity, so the streams are only allocated once and clipped vertices appended last frame are dropped
+	streams.Resize(mesh.vertices.size());
 	const Matrix worldViewProjectionMatrix{ mesh.worldMatrix * m_Camera.viewMatrix * m_Camera.projectionMatrix };
 
-	for(const auto& vertex : mesh.vertices)
-	{
-		//World -> view space
-		Vertex_Out vertexOut{};
-		vertexOut.position = worldViewProjectionMatrix.TransformPoint(vertex.position.x, vertex.position.y, vertex.position.z, 0);
-		vertexOut.color = vertex.color;
-		vertexOut.uv = vertex.uv;
-		vertexOut.normal = mesh.worldMatrix.TransformVector(vertex.normal);
-		vertexOut.tangent = mesh.worldMatrix.TransformVector(vertex.tangent);
-		vertexOut.viewDirection = mesh.worldMatrix.TransformPoint(vertex.position) - m_Camera.origin;
+	const auto transformVertex = [&](uint32_t vertexIndex)
+		{
+			Vertex_Out vertexOut{ TransformVertex(mesh.vertices[vertexIndex], worldViewProjectionMatrix, mesh.worldMatrix, streams.attributes) };
+			ProjectToScreen(vertexOut);
+
+			streams.Store(vertexIndex, vertexOut);
+		};
 
-		//pespective divide = View space -> clipping space (NDC)
-		vertexOut.position.w = 1.f / vertexOut.position.w;
-		vertexOut.position.x *= vertexOut.position.w;
-		vertexOut.position.y *= vertexOut.position.w;
-		vertexOut.position.z *= vertexOut.position.w;
+	//Every vertex writes only its own slot of each stream, so the vertices can be transformed in parallel
+	const auto firstVertexIndex{ m_VertexIndices.cbegin() };
+	const auto lastVertexIndex{ firstVertexIndex + mesh.vertices.size() };
+#ifdef PARALLEL_EXECUTION
+	std::for_each(std::execution::par_unseq, firstVertexIndex, lastVertexIndex, transformVertex);
+#else
+	std::for_each(firstVertexIndex, lastVertexIndex, transformVertex);
+#endif
+}
 
-		//NDC -> screen space
-		vertexOut.position.x = { ((vertexOut.position.x + 1) * 0.5f) * static_cast<float>(m_Width) };
-		vertexOut.position.y = { ((1 - vertexOut.position.y) * 0.5f) * static_cast<float>(m_Height) };
+Vertex_Out Renderer::TransformVertex(const Vertex& vertex, const Matrix& worldViewProjectionMatrix, const Matrix& worldMatrix, const VertexAttributes& attributes) const
+{
+	//World -> view space
+	Vertex_Out vertexOut{};
+	vertexOut.position = worldViewProjectionMatrix.TransformPoint(vertex.position.x, vertex.position.y, vertex.position.z, 0);
+	vertexOut.color = vertex.color;
+	vertexOut.uv = vertex.uv;
 
-		mesh.vertices_out.push_back(vertexOut);
+	if (attributes.normal)
+	{
+		vertexOut.normal = worldMatrix.TransformVector(vertex.normal);
+	}
+	if (attributes.tangent)
+	{
+		vertexOut.tangent = worldMatrix.TransformVector(vertex.tangent);
+	}
+	if (attributes.viewDirection)
+	{
+		vertexOut.viewDirection = worldMatrix.TransformPoint(vertex.position) - m_Camera.origin;
 	}
+
+	return vertexOut;
+}
+
+void Renderer::ProjectToScreen(Vertex_Out& vertex) const
+{
+	//pespective divide = View space -> clipping space (NDC)
+	vertex.position.w = 1.f / vertex.position.w;
+	vertex.position.x *= vertex.position.w;
+	vertex.position.y *= vertex.position.w;
+	vertex.position.z *= vertex.position.w;
+
+	//NDC -> screen space
+	vertex.position.x = { ((vertex.position.x + 1) * 0.5f) * static_cast<float>(m_Width) };
+	vertex.position.y = { ((1 - vertex.position.y) * 0.5f) * static_cast<float>(m_Height) };
+}
+
+Vertex_Out Renderer::LerpVertex(const Vertex_Out& v0, const Vertex_Out& v1, float factor)
+{
+	//Clip space attributes are linear, so the new vertex is interpolated perspective correctly
+	Vertex_Out vertexOut{};
+	vertexOut.position = v0.position + ((v1.position - v0.position) * factor);
+	vertexOut.color = ColorRGB::Lerp(v0.color, v1.color, factor);
+	vertexOut.uv = v0.uv + ((v1.uv - v0.uv) * factor);
+	vertexOut.normal = v0.normal + ((v1.normal - v0.normal) * factor);
+	vertexOut.tangent = v0.tangent + ((v1.tangent - v0.tangent) * factor);
+	vertexOut.viewDirection = v0.viewDirection + ((v1.viewDirection - v0.viewDirection) * factor);
+
+	return vertexOut;
+}
+
+void Renderer::SelectPixelKernels()
+{
+	//The depth view ignores shading mode and normal mapping
+	static const PixelKernels depthViewKernels{ PixelKernels::Create<ShadingState<ShadingMode::combined, false, true>>() };
+
+	//Indexed by shading mode, then by normal mapping
+	static const PixelKernels shadingKernels[static_cast<int>(ShadingMode::number)][2]
+	{
+		{
+			PixelKernels::Create<ShadingState<ShadingMode::observedArea, false, false>>(),
+			PixelKernels::Create<ShadingState<ShadingMode::observedArea, true, false>>()
+		},
+		{
+			PixelKernels::Create<ShadingState<ShadingMode::diffuse, false, false>>(),
+			PixelKernels::Create<ShadingState<ShadingMode::diffuse, true, false>>()
+		},
+		{
+			PixelKernels::Create<ShadingState<ShadingMode::specular, false, false>>(),
+			PixelKernels::Create<ShadingState<ShadingMode::specular, true, false>>()
+		},
+		{
+			PixelKernels::Create<ShadingState<ShadingMode::combined, false, false>>(),
+			PixelKernels::Create<ShadingState<ShadingMode::combined, true, false>>()
+		},
+		{
+			PixelKernels::Create<ShadingState<ShadingMode::overdraw, false, false>>(),
+			PixelKernels::Create<ShadingState<ShadingMode::overdraw, true, false>>()
+		}
+	};
+
+	m_pPixelKernels = m_DepthBufferOn ? &depthViewKernels : &shadingKernels[static_cast<int>(m_CurrentShadingMode)][m_NormalMappingOn];
 }
 
 void Renderer::VertexTransformationFunction(std::vector<Mesh>& meshes) const
 {
+	PROFILE_ZONE("VertexTransformation");
+
 	for(auto& mesh : meshes)
 	{
-		VertexTransformationFunction(mesh);
+		if (mesh.isVisible)
+		{
+			VertexTransformationFunction(mesh);
+		}
 	}
 }
 
-ColorRGB Renderer::PixelShading(const Vertex_Out& v)
+template<typename State>
+ColorRGB Renderer::PixelShading(const Vertex_Out& v, const SpanTextureSamples& samples, int index) const
 {
 	const Vector3 lightDirection = { .577f, -.577f, .577f };
-	const Vector3 binormal = Vector3::Cross(v.normal, v.tangent);
 	const float lightIntensity{ 7.f };
 
 	ColorRGB currentFinalColor{};
 
-	
-	ColorRGB glossSample = m_pTextureGloss->Sample(v.uv);
-	ColorRGB specularSample = m_pTextureSpecular->Sample(v.uv);
-	ColorRGB diffuseSample = m_pTextureDiffuse->Sample(v.uv);
-
-	diffuseSample = (diffuseSample * lightIntensity) / PI;
+	ColorRGB diffuseSample{};
+	if constexpr (State::needsDiffuse)
+	{
+		diffuseSample = (samples.diffuse[index] * lightIntensity) / PI;
+	}
 
-	Matrix tangentSpaceAxis = Matrix{ v.tangent, binormal, v.normal, Vector3::Zero };
 	Vector3 normals{};
 
-	if(m_NormalMappingOn)
+	if constexpr (State::needsNormal && State::normalMapping)
 	{
-		ColorRGB normalSample = m_pTextureNormal->Sample(v.uv);
+		const Vector3 binormal = Vector3::Cross(v.normal, v.tangent);
+		Matrix tangentSpaceAxis = Matrix{ v.tangent, binormal, v.normal, Vector3::Zero };
+
+		ColorRGB normalSample = samples.normal[index];
 		normalSample /= 255.f;
 		normalSample *= 2.f;
 		normalSample -= ColorRGB(1.f, 1.f, 1.f);
 
 		normals = tangentSpaceAxis.TransformVector(Vector3(normalSample.r, normalSample.g, normalSample.b));
 	}
-	else
+	else if constexpr (State::needsNormal)
 	{
 		normals = v.normal;
 	}
 
 	const float observedArea{ Vector3::Dot(normals, lightDirection) };
 
-	glossSample *= m_Shininess;
-	specularSample = specularSample * powf(std::max(Vector3::Dot(lightDirection - (2.f * std::max(Vector3::Dot(normals, lightDirection), 0.f) * normals), v.viewDirection), 0.f), glossSample.r);
-	specularSample.MaxToOne();
+	ColorRGB specularSample{};
+	if constexpr (State::needsSpecular)
+	{
+		ColorRGB glossSample = samples.gloss[index];
+		specularSample = samples.specular[index];
+
+		glossSample *= m_Shininess;
+		specularSample = specularSample * powf(std::max(Vector3::Dot(lightDirection - (2.f * std::max(Vector3::Dot(normals, lightDirection), 0.f) * normals), v.viewDirection), 0.f), glossSample.r);
+		specularSample.MaxToOne();
+	}
 
-	
-	switch (m_CurrentShadingMode)
+	if constexpr (State::shadingMode == ShadingMode::observedArea)
 	{
-	case dae::Renderer::ShadingMode::observedArea:
 		if (observedArea > 0.f)
 		{
 			currentFinalColor = ColorRGB(observedArea, observedArea, observedArea);
 		}
-		break;
-	case dae::Renderer::ShadingMode::diffuse:
+	}
+	else if constexpr (State::shadingMode == ShadingMode::diffuse)
+	{
 		currentFinalColor = diffuseSample + m_Ambient;
-		break;
-	case dae::Renderer::ShadingMode::specular:
+	}
+	else if constexpr (State::shadingMode == ShadingMode::specular)
+	{
 		currentFinalColor = specularSample;
-		break;
-	case dae::Renderer::ShadingMode::combined:
+	}
+	else if constexpr (State::shadingMode == ShadingMode::combined)
+	{
 		if (observedArea > 0.f)
 		{
 			currentFinalColor = observedArea * (diffuseSample + m_Ambient + specularSample);
 		}
-		break;
-	default:
-		break;
 	}
 
 	return currentFinalColor;
@@ -393,6 +1588,37 @@ void Renderer::ToggleNormalMapping()
 	m_NormalMappingOn = !m_NormalMappingOn;
 }
 
+void Renderer::ToggleSIMDRasterization()
+{
+	m_SIMDRasterizationOn = !m_SIMDRasterizationOn;
+}
+
+void Renderer::ToggleDeferredShading()
+{
+	m_DeferredShadingOn = !m_DeferredShadingOn;
+}
+
+void Renderer::CycleCullMode()
+{
+	m_PrimitiveAssembler.CycleCullMode();
+}
+
+void Renderer::CycleTextureFilter()
+{
+	m_TextureFilter = static_cast<Texture::Filter>((static_cast<int>(m_TextureFilter) + 1) % static_cast<int>(Texture::Filter::number));
+}
+
+void Renderer::CycleTexelLayout()
+{
+	m_Scene.texelLayout = static_cast<Texture::Layout>((static_cast<int>(m_Scene.texelLayout) + 1) % static_cast<int>(Texture::Layout::number));
+	LoadTextures();
+}
+
+const Renderer::FrameStatistics& Renderer::GetFrameStatistics() const
+{
+	return m_FrameStatistics;
+}
+
 void Renderer::CycleShadingMode()
 {
 	m_CurrentShadingMode = static_cast<ShadingMode>((static_cast<int>(m_CurrentShadingMode) + 1) % static_cast<int>(ShadingMode::number));
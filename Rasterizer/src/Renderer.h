@@ -1,27 +1,77 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include "Camera.h"
+#include "FramebufferWriter.h"
+#include "PrimitiveAssembler.h"
+#include "Texture.h"
 
-struct SDL_Window;
 struct SDL_Surface;
 
 namespace dae
 {
 	struct Vertex_Out;
-	class Texture;
 	struct Mesh;
 	struct Vertex;
+	struct VertexAttributes;
 	class Timer;
+	class RenderTarget;
 	class Scene;
 	struct TriangleBoundingBox;
+	struct Triangle;
+	struct Tile;
 
 	class Renderer final
 	{
 	public:
-		Renderer(SDL_Window* pWindow);
+		//Counters of the last rendered frame
+		struct FrameStatistics
+		{
+			uint32_t meshesCulled{};
+
+			//Triangles of the visible meshes, every culled one is counted under the test that rejected it
+			//Clipping can split a triangle, its pieces are culled and rasterized on their own
+			uint32_t trianglesSubmitted{};
+			uint32_t trianglesCulledDegenerate{};
+			uint32_t trianglesCulledFacing{};
+			uint32_t trianglesCulledClipped{};
+
+			//Counted once for every tile the triangle was binned to
+			uint32_t trianglesCulledHiZ{};
+			uint32_t trianglesRasterized{};
+
+			//Covered pixels that reached the depth test, the ones that passed it and PixelShading invocations
+			uint64_t pixelsTested{};
+			uint64_t pixelsPassedDepth{};
+			uint64_t pixelsShaded{};
+		};
+
+		//What the renderer draws, every path is relative to the working directory
+		struct SceneDescription
+		{
+			std::string meshPath{ "Resources/vehicle.obj" };
+
+			//An empty path, or one that does not load, is replaced by a 1x1 texture that leaves the shading plain:
+			//a grey diffuse, the color of a flat normal map, no gloss and no specular
+			std::string diffuseTexturePath{ "Resources/vehicle_diffuse.png" };
+			std::string normalTexturePath{ "Resources/vehicle_normal.png" };
+			std::string glossTexturePath{ "Resources/vehicle_gloss.png" };
+			std::string specularTexturePath{ "Resources/vehicle_specular.png" };
+
+			//The mesh rotates around its own origin, placed here
+			Vector3 meshPosition{ 0.f, 0.f, -40.f };
+
+			Texture::Layout texelLayout{ Texture::Layout::linear };
+
+			//Prints the vertex and triangle count and the ACMR before and after reordering once the mesh is loaded
+			bool reportMeshStatistics{ false };
+		};
+
+		explicit Renderer(RenderTarget* pRenderTarget);
+		Renderer(RenderTarget* pRenderTarget, const SceneDescription& scene);
 		~Renderer();
 
 		Renderer(const Renderer&) = delete;
@@ -36,35 +86,142 @@ namespace dae
 
 		void VertexTransformationFunction(Mesh& mesh) const;
 		void VertexTransformationFunction(std::vector<Mesh>& meshes) const;
+		Vertex_Out TransformVertex(const Vertex& vertex, const Matrix& worldViewProjectionMatrix, const Matrix& worldMatrix, const VertexAttributes& attributes) const;
+		void ProjectToScreen(Vertex_Out& vertex) const;
+		static Vertex_Out LerpVertex(const Vertex_Out& v0, const Vertex_Out& v1, float factor);
 
-		ColorRGB PixelShading(const Vertex_Out& v);
+		//Triangles reaching beyond NDC x/y of +-GUARD_BAND get clipped against x/y, everything inside
+		//is rasterized directly and only limited by the bounding box, keeping edge functions precise
+		static constexpr float GUARD_BAND{ 8.f };
+
+		//A triangle grows by at most one vertex for every plane it gets clipped against
+		static constexpr int MAX_CLIP_POLYGON_SIZE{ 3 + 6 };
+
+		//Clips a clip space polygon in place against the near and far plane and the guard band,
+		//pPolygon holds MAX_CLIP_POLYGON_SIZE vertices, returns the new vertex count, 0 when it is completely outside
+		static int ClipPolygon(Vertex_Out* pPolygon, int polygonSize);
 
 		void ToggleDepthBuffer();
 		void ToggleRotate();
 		void ToggleNormalMapping();
+		void ToggleSIMDRasterization();
+		void ToggleDeferredShading();
+		void CycleCullMode();
+		void CycleTexelLayout();
+		void CycleTextureFilter();
+
+		const FrameStatistics& GetFrameStatistics() const;
 		void CycleShadingMode();
 
 	private:
+		static constexpr int TILE_SIZE{ 64 };
+		static constexpr int HIZ_BLOCK_SIZE{ 8 };
+
+		//Most pixels ShadePixels takes at once, one SIMD span
+		static constexpr int SHADING_SPAN_WIDTH{ 8 };
+		static constexpr uint32_t INVALID_TRIANGLE_INDEX{ UINT32_MAX };
+
+		void LoadTextures();
+		void InitializeTiles();
+		void CullMeshes();
+		bool IsInsideFrustum(const Mesh& mesh) const;
+		void AssemblePrimitives();
+		bool IsInsideClipVolume(const Vector4& position) const;
+		void ClipTriangle(uint32_t meshIndex, uint32_t vertex0, uint32_t vertex1, uint32_t vertex2, const Matrix& worldViewProjectionMatrix);
+		void BinTriangles();
+		void BinTriangle(uint32_t triangleIndex);
+		void SetupTriangle(Triangle& triangle) const;
+		void ClearTile(const Tile& tile);
+		void RenderTile(Tile& tile);
+		bool RasterizeTriangle(uint32_t triangleIndex, Tile& tile);
+		template<typename State>
+		bool RasterizeBlockScalar(uint32_t triangleIndex, const TriangleBoundingBox& pixelBox, Tile& tile);
+		template<typename State>
+		bool RasterizeBlockSIMD(uint32_t triangleIndex, const TriangleBoundingBox& pixelBox, Tile& tile);
+		void UpdateBlockDepth(int blockX, int blockY);
+		void UpdateTileDepth(Tile& tile);
+		template<typename State>
+		void ResolveTile(Tile& tile);
+		void ResolveOverdrawTile(const Tile& tile);
+		void SelectPixelKernels();
+		struct SpanTextureSamples;
+
+		template<typename State>
+		ColorRGB ShadePixel(const Mesh& mesh, const Triangle& triangle, int px, int py, float weightV0, float weightV1, float weightV2, float pixelDepth) const;
+		template<typename State>
+		Vertex_Out InterpolatePixel(const Mesh& mesh, const Triangle& triangle, int px, int py, float weightV0, float weightV1, float weightV2, float pixelDepth) const;
+		template<typename State>
+		void ShadePixels(const Vertex_Out* pPixels, int count, ColorRGB* pColors) const;
+		template<typename State>
+		void SampleTextures(const Vertex_Out* pPixels, int count, SpanTextureSamples& samples) const;
+		template<typename State>
+		ColorRGB PixelShading(const Vertex_Out& v, const SpanTextureSamples& samples, int index) const;
+
 		enum class ShadingMode
 		{
 			observedArea,
 			diffuse,
 			specular,
 			combined,
+			overdraw,
 			number
 		};
 
 		ShadingMode m_CurrentShadingMode{ShadingMode::combined };
 
-		SDL_Window* m_pWindow{};
+		//Everything a pixel kernel is specialized on, fixed for a whole frame
+		template<ShadingMode Mode, bool NormalMapping, bool DepthView>
+		struct ShadingState
+		{
+			static constexpr ShadingMode shadingMode{ Mode };
+			static constexpr bool normalMapping{ NormalMapping };
+			static constexpr bool depthView{ DepthView };
+
+			static constexpr bool needsDiffuse{ !DepthView && (Mode == ShadingMode::diffuse || Mode == ShadingMode::combined) };
+			static constexpr bool needsSpecular{ !DepthView && (Mode == ShadingMode::specular || Mode == ShadingMode::combined) };
+			static constexpr bool needsNormal{ !DepthView && Mode != ShadingMode::diffuse && Mode != ShadingMode::overdraw };
+
+			//Overdraw counts every covered pixel and never shades, the counts become a heatmap per tile
+			static constexpr bool overdrawView{ !DepthView && Mode == ShadingMode::overdraw };
+			static constexpr bool callsPixelShading{ !DepthView && !overdrawView };
+
+			//Post-transform attributes the kernel reads, the transform skips the rest
+			static constexpr VertexAttributes attributes
+			{
+				needsDiffuse || needsSpecular || (needsNormal && NormalMapping),
+				needsNormal,
+				needsNormal && NormalMapping,
+				needsSpecular
+			};
+		};
+
+		struct PixelKernels;
+		const PixelKernels* m_pPixelKernels{};
+
+		FrameStatistics m_FrameStatistics{};
+
+		RenderTarget* m_pRenderTarget{};
 
-		SDL_Surface* m_pFrontBuffer{ nullptr };
 		SDL_Surface* m_pBackBuffer{ nullptr };
 		uint32_t* m_pBackBufferPixels{};
 
+		FramebufferWriter m_FramebufferWriter{};
+		uint32_t m_ClearPixel{};
+
 		float* m_pDepthBufferPixels{};
 
+		//Hierarchical depth: farthest depth per HIZ_BLOCK_SIZE block, tiles keep the farthest of their blocks
+		float* m_pHiZMaxDepth{};
+		int m_HiZBlockCount{};
+
+		//Deferred shading: index of the visible triangle per pixel, the triangle knows its mesh and vertices
+		uint32_t* m_pVisibilityBufferPixels{};
+
+		//Overdraw view: number of covered pixels that reached the depth test, per pixel
+		uint32_t* m_pOverdrawPixels{};
+
 		Camera m_Camera{};
+		SceneDescription m_Scene{};
 
 		int m_Width{};
 		int m_Height{};
@@ -73,12 +230,23 @@ namespace dae
 		Texture* m_pTextureGloss{};
 		Texture* m_pTextureNormal{};
 		Texture* m_pTextureSpecular{};
+		Texture::Filter m_TextureFilter{ Texture::Filter::point };
 
 		std::vector<Mesh> m_Meshes;
 
+		//0 up to the largest vertex count, the parallel vertex transform walks these instead of the vertices themselves
+		std::vector<uint32_t> m_VertexIndices;
+
+		//Triangles of the current frame in submission order, tiles and the visibility buffer index into them
+		PrimitiveAssembler m_PrimitiveAssembler;
+		std::vector<uint32_t> m_ResolvedIndices;
+		std::vector<Tile> m_Tiles;
+
 		bool m_DepthBufferOn;
 		bool m_RotatingOn;
 		bool m_NormalMappingOn;
+		bool m_SIMDRasterizationOn;
+		bool m_DeferredShadingOn;
 
 		ColorRGB m_Ambient;
 		float m_Shininess;
@@ -1,15 +1,25 @@
 //External includes
+#ifdef _MSC_VER
 #include "vld.h"
+#endif
 #include "SDL.h"
 #include "SDL_surface.h"
 #undef main
 
 //Standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <string>
 
 //Project includes
+#include "Profiler.h"
 #include "Timer.h"
 #include "Renderer.h"
+#include "RenderTarget.h"
 
 using namespace dae;
 
@@ -19,18 +29,151 @@ void ShutDown(SDL_Window* pWindow)
 	SDL_Quit();
 }
 
-int main(int argc, char* args[])
+//The default scene, reporting the mesh statistics once at load; the unit tests build their renderers without the report
+Renderer::SceneDescription CreateScene()
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	Renderer::SceneDescription scene{};
+	scene.reportMeshStatistics = true;
+	return scene;
+}
 
-	//Create window + surfaces
-	SDL_Init(SDL_INIT_VIDEO);
+void PrintFrameStatistics(float dFPS, const Renderer::FrameStatistics& statistics)
+{
+	std::cout << "dFPS: " << dFPS
+		<< " | triangles: " << statistics.trianglesSubmitted << " submitted, "
+		<< statistics.trianglesRasterized << " rasterized"
+		<< " | culled: " << statistics.meshesCulled << " meshes (frustum), "
+		<< statistics.trianglesCulledDegenerate << " degenerate, "
+		<< statistics.trianglesCulledFacing << " facing, "
+		<< statistics.trianglesCulledClipped << " clipped, "
+		<< statistics.trianglesCulledHiZ << " Hi-Z"
+		<< " | pixels: " << statistics.pixelsTested << " tested, "
+		<< statistics.pixelsPassedDepth << " passed depth, "
+		<< statistics.pixelsShaded << " shaded" << std::endl;
+}
 
+//Renders frameCount frames into memory and writes them out as bitmaps, no window or video subsystem needed
+//The stage timings of every frame are written to trace.json, open it in chrome://tracing or Perfetto
+int RunHeadless(int frameCount, const std::string& outputDirectory, int width, int height)
+{
+	std::error_code error{};
+	std::filesystem::create_directories(outputDirectory, error);
+	if (error)
+	{
+		std::cout << "Could not create " << outputDirectory << ": " << error.message() << std::endl;
+		return 1;
+	}
+
+	const auto pTimer = new Timer();
+	const auto pRenderTarget = new RenderTarget(width, height);
+	const auto pRenderer = new Renderer(pRenderTarget, CreateScene());
+
+	//Frames are a fixed 1/60 second apart, so every run renders the same images
+	pTimer->SetFixedElapsed(1.f / 60.f);
+	pTimer->Start();
+
+	Profiler::BeginCapture(static_cast<uint32_t>(std::max(frameCount, 0)), outputDirectory + "/trace.json");
+
+	int result = 0;
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		pRenderer->Update(pTimer);
+		pRenderer->Render();
+		Profiler::EndFrame();
+		pTimer->Update();
+
+		std::ostringstream path{};
+		path << outputDirectory << "/frame_" << std::setw(4) << std::setfill('0') << frame << ".bmp";
+		if (!pRenderTarget->SaveColorBuffer(path.str()))
+		{
+			std::cout << "Something went wrong. " << path.str() << " not saved!" << std::endl;
+			result = 1;
+			break;
+		}
+	}
+	pTimer->Stop();
+
+	std::cout << "Rendered " << frameCount << " frames to " << outputDirectory << std::endl;
+
+	delete pRenderer;
+	delete pRenderTarget;
+	delete pTimer;
+
+	SDL_Quit();
+	return result;
+}
+
+void PrintBenchmarkResult(const Timer::BenchmarkResult& result)
+{
+	std::cout << "Benchmark: " << result.frameCount << " frames"
+		<< " | mean " << result.mean << " ms"
+		<< " | median " << result.median << " ms"
+		<< " | p95 " << result.p95 << " ms"
+		<< " | p99 " << result.p99 << " ms"
+		<< " | max " << result.max << " ms" << std::endl;
+}
+
+//Renders and times a fixed benchmark session into memory, then writes benchmark.csv and benchmark.json
+int RunBenchmark(uint32_t warmupFrames, uint32_t measuredFrames, const std::string& outputDirectory, int width, int height)
+{
+	std::error_code error{};
+	std::filesystem::create_directories(outputDirectory, error);
+	if (error)
+	{
+		std::cout << "Could not create " << outputDirectory << ": " << error.message() << std::endl;
+		return 1;
+	}
+
+	const auto pTimer = new Timer();
+	const auto pRenderTarget = new RenderTarget(width, height);
+	const auto pRenderer = new Renderer(pRenderTarget, CreateScene());
+
+	pTimer->Start();
+	pTimer->StartBenchmark(warmupFrames, measuredFrames);
+
+	while (!pTimer->IsBenchmarkFinished())
+	{
+		pRenderer->Update(pTimer);
+		pRenderer->Render();
+		pTimer->Update();
+	}
+	pTimer->Stop();
+
+	PrintBenchmarkResult(pTimer->GetBenchmarkResult());
+	const bool isWritten = pTimer->WriteBenchmarkReport(outputDirectory + "/benchmark.csv", outputDirectory + "/benchmark.json");
+	if (!isWritten)
+		std::cout << "Something went wrong. Benchmark report not saved!" << std::endl;
+
+	delete pRenderer;
+	delete pRenderTarget;
+	delete pTimer;
+
+	SDL_Quit();
+	return isWritten ? 0 : 1;
+}
+
+int main(int argc, char* args[])
+{
 	const uint32_t width = 640;
 	const uint32_t height = 480;
 
+	//Headless: Rasterizer --headless <frameCount> [outputDirectory]
+	if (argc >= 3 && std::string(args[1]) == "--headless")
+	{
+		return RunHeadless(std::atoi(args[2]), (argc >= 4) ? args[3] : "Frames", width, height);
+	}
+
+	//Benchmark: Rasterizer --benchmark [warmupFrames] [measuredFrames] [outputDirectory]
+	if (argc >= 2 && std::string(args[1]) == "--benchmark")
+	{
+		const uint32_t warmupFrames = (argc >= 3) ? static_cast<uint32_t>(std::atoi(args[2])) : 60;
+		const uint32_t measuredFrames = (argc >= 4) ? static_cast<uint32_t>(std::atoi(args[3])) : 600;
+		return RunBenchmark(warmupFrames, measuredFrames, (argc >= 5) ? args[4] : ".", width, height);
+	}
+
+	//Create window + surfaces
+	SDL_Init(SDL_INIT_VIDEO);
+
 	SDL_Window* pWindow = SDL_CreateWindow(
 		"Rasterizer - Leen Ritserveldt (2DAE10)",
 		SDL_WINDOWPOS_UNDEFINED,
@@ -42,13 +185,13 @@ int main(int argc, char* args[])
 
 	//Initialize "framework"
 	const auto pTimer = new Timer();
-	const auto pRenderer = new Renderer(pWindow);
+	const auto pRenderTarget = new WindowRenderTarget(pWindow);
+	const auto pRenderer = new Renderer(pRenderTarget, CreateScene());
 
 	//Start loop
 	pTimer->Start();
 
-	// Start Benchmark
-	// TODO pTimer->StartBenchmark();
+	const uint32_t profileCaptureFrames = 10;
 
 	float printTimer = 0.f;
 	bool isLooping = true;
@@ -67,6 +210,10 @@ int main(int argc, char* args[])
 			case SDL_KEYUP:
 				if (e.key.keysym.scancode == SDL_SCANCODE_X)
 					takeScreenshot = true;
+				if (e.key.keysym.scancode == SDL_SCANCODE_F2)
+					pRenderer->CycleTextureFilter();
+				if (e.key.keysym.scancode == SDL_SCANCODE_F3)
+					pRenderer->CycleTexelLayout();
 				if (e.key.keysym.scancode == SDL_SCANCODE_F4)
 					pRenderer->ToggleDepthBuffer();
 				if (e.key.keysym.scancode == SDL_SCANCODE_F5)
@@ -75,6 +222,22 @@ int main(int argc, char* args[])
 					pRenderer->ToggleNormalMapping();
 				if (e.key.keysym.scancode == SDL_SCANCODE_F7)
 					pRenderer->CycleShadingMode();
+				if (e.key.keysym.scancode == SDL_SCANCODE_F8)
+					pRenderer->ToggleSIMDRasterization();
+				if (e.key.keysym.scancode == SDL_SCANCODE_F9)
+					pRenderer->ToggleDeferredShading();
+				if (e.key.keysym.scancode == SDL_SCANCODE_F10)
+					pRenderer->CycleCullMode();
+				if (e.key.keysym.scancode == SDL_SCANCODE_F11 && !pTimer->IsBenchmarkRunning())
+				{
+					std::cout << "Benchmark started" << std::endl;
+					pTimer->StartBenchmark();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_F12 && !Profiler::IsCapturing())
+				{
+					std::cout << "Profile capture started" << std::endl;
+					Profiler::BeginCapture(profileCaptureFrames, "trace.json");
+				}
 				break;
 			}
 		}
@@ -84,6 +247,7 @@ int main(int argc, char* args[])
 
 		//--------- Render ---------
 		pRenderer->Render();
+		Profiler::EndFrame();
 
 		//--------- Timer ---------
 		pTimer->Update();
@@ -91,7 +255,16 @@ int main(int argc, char* args[])
 		if (printTimer >= 1.f)
 		{
 			printTimer = 0.f;
-			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+			PrintFrameStatistics(pTimer->GetdFPS(), pRenderer->GetFrameStatistics());
+		}
+
+		//Benchmark finished, report it and go back to the wall clock
+		if (pTimer->IsBenchmarkFinished())
+		{
+			PrintBenchmarkResult(pTimer->GetBenchmarkResult());
+			if (!pTimer->WriteBenchmarkReport("benchmark.csv", "benchmark.json"))
+				std::cout << "Something went wrong. Benchmark report not saved!" << std::endl;
+			pTimer->EndBenchmark();
 		}
 
 		//Save screenshot after full render
@@ -108,6 +281,7 @@ int main(int argc, char* args[])
 
 	//Shutdown "framework"
 	delete pRenderer;
+	delete pRenderTarget;
 	delete pTimer;
 
 	ShutDown(pWindow);
@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+
+//Standard includes
+#include <cmath>
+
+//Project includes
+#include "DataTypes.h"
+#include "Renderer.h"
+
+namespace dae
+{
+	namespace
+	{
+		Vertex_Out CreateVertex(const Vector4& position, const Vector2& uv, const ColorRGB& color)
+		{
+			Vertex_Out vertex{};
+			vertex.position = position;
+			vertex.uv = uv;
+			vertex.color = color;
+			vertex.normal = { 0.f, 0.f, 1.f };
+			return vertex;
+		}
+
+		void ExpectInsideClipVolume(const Vertex_Out* pPolygon, int polygonSize)
+		{
+			for (int index{}; index < polygonSize; ++index)
+			{
+				const Vector4& position{ pPolygon[index].position };
+				EXPECT_GE(position.z, 0.f) << "vertex " << index;
+				EXPECT_LE(position.z, position.w) << "vertex " << index;
+				EXPECT_LE(std::abs(position.x), Renderer::GUARD_BAND * position.w) << "vertex " << index;
+				EXPECT_LE(std::abs(position.y), Renderer::GUARD_BAND * position.w) << "vertex " << index;
+			}
+		}
+	}
+
+	TEST(ClippingTest, InsideTriangleIsUnchanged)
+	{
+		Vertex_Out polygon[Renderer::MAX_CLIP_POLYGON_SIZE]
+		{
+			CreateVertex({ 0.f, 0.f, 0.5f, 1.f }, { 0.f, 0.f }, colors::Red),
+			CreateVertex({ 1.f, 0.f, 0.5f, 1.f }, { 1.f, 0.f }, colors::Green),
+			CreateVertex({ 0.f, 1.f, 0.5f, 1.f }, { 0.f, 1.f }, colors::Blue)
+		};
+
+		ASSERT_EQ(Renderer::ClipPolygon(polygon, 3), 3);
+		EXPECT_EQ(polygon[1].position, Vector4(1.f, 0.f, 0.5f, 1.f));
+		EXPECT_EQ(polygon[2].uv, Vector2(0.f, 1.f));
+	}
+
+	TEST(ClippingTest, OneVertexBeyondNearPlaneGivesQuad)
+	{
+		//v2 lies beyond the near plane (z > w), v1 -> v2 crosses it a quarter along, v2 -> v0 three quarters along
+		Vertex_Out polygon[Renderer::MAX_CLIP_POLYGON_SIZE]
+		{
+			CreateVertex({ 0.f, 0.f, 0.5f, 1.f }, { 0.f, 0.f }, colors::Red),
+			CreateVertex({ 1.f, 0.f, 0.5f, 1.f }, { 1.f, 0.f }, colors::Green),
+			CreateVertex({ 0.f, 1.f, 2.5f, 1.f }, { 0.f, 1.f }, colors::Blue)
+		};
+
+		ASSERT_EQ(Renderer::ClipPolygon(polygon, 3), 4);
+
+		//The inside vertices keep their order, the crossing points follow them
+		EXPECT_EQ(polygon[0].uv, Vector2(0.f, 0.f));
+		EXPECT_EQ(polygon[1].uv, Vector2(1.f, 0.f));
+
+		EXPECT_FLOAT_EQ(polygon[2].position.x, 0.75f);
+		EXPECT_FLOAT_EQ(polygon[2].position.y, 0.25f);
+		EXPECT_FLOAT_EQ(polygon[2].position.z, 1.f);
+		EXPECT_FLOAT_EQ(polygon[2].uv.x, 0.75f);
+		EXPECT_FLOAT_EQ(polygon[2].uv.y, 0.25f);
+		EXPECT_FLOAT_EQ(polygon[2].color.g, 0.75f);
+		EXPECT_FLOAT_EQ(polygon[2].color.b, 0.25f);
+
+		EXPECT_FLOAT_EQ(polygon[3].position.x, 0.f);
+		EXPECT_FLOAT_EQ(polygon[3].position.y, 0.25f);
+		EXPECT_FLOAT_EQ(polygon[3].position.z, 1.f);
+		EXPECT_FLOAT_EQ(polygon[3].uv.x, 0.f);
+		EXPECT_FLOAT_EQ(polygon[3].uv.y, 0.25f);
+		EXPECT_FLOAT_EQ(polygon[3].color.r, 0.75f);
+		EXPECT_FLOAT_EQ(polygon[3].color.b, 0.25f);
+
+		//Attributes the vertices share stay put
+		EXPECT_EQ(polygon[2].normal, Vector3(0.f, 0.f, 1.f));
+		EXPECT_EQ(polygon[3].normal, Vector3(0.f, 0.f, 1.f));
+
+		ExpectInsideClipVolume(polygon, 4);
+	}
+
+	TEST(ClippingTest, ClipSpaceInterpolationIsPerspectiveCorrect)
+	{
+		//v2 is behind the camera with a negative w, the cut lands where z == w along the clip space edge
+		Vertex_Out polygon[Renderer::MAX_CLIP_POLYGON_SIZE]
+		{
+			CreateVertex({ 0.f, 0.f, 0.5f, 2.f }, { 0.f, 0.f }, colors::Black),
+			CreateVertex({ 0.f, 2.f, 0.5f, 2.f }, { 0.f, 1.f }, colors::Black),
+			CreateVertex({ 0.f, 0.f, 3.f, -2.f }, { 1.f, 0.f }, colors::Black)
+		};
+
+		ASSERT_EQ(Renderer::ClipPolygon(polygon, 3), 4);
+
+		//Near distances w - z: 1.5, 1.5 and -5, both edges to v2 are cut 1.5 / 6.5 away from their inside vertex
+		constexpr float factor{ 1.5f / 6.5f };
+		EXPECT_FLOAT_EQ(polygon[2].position.z, polygon[2].position.w);
+		EXPECT_FLOAT_EQ(polygon[2].uv.x, factor);
+		EXPECT_FLOAT_EQ(polygon[2].uv.y, 1.f - factor);
+		EXPECT_FLOAT_EQ(polygon[3].position.z, polygon[3].position.w);
+		EXPECT_FLOAT_EQ(polygon[3].uv.x, factor);
+		EXPECT_FLOAT_EQ(polygon[3].uv.y, 0.f);
+
+		ExpectInsideClipVolume(polygon, 4);
+	}
+
+	TEST(ClippingTest, TwoVerticesBeyondNearPlaneGiveTriangle)
+	{
+		Vertex_Out polygon[Renderer::MAX_CLIP_POLYGON_SIZE]
+		{
+			CreateVertex({ 0.f, 0.f, 0.f, 1.f }, { 0.f, 0.f }, colors::Red),
+			CreateVertex({ 1.f, 0.f, 2.f, 1.f }, { 1.f, 0.f }, colors::Green),
+			CreateVertex({ 0.f, 1.f, 2.f, 1.f }, { 0.f, 1.f }, colors::Blue)
+		};
+
+		ASSERT_EQ(Renderer::ClipPolygon(polygon, 3), 3);
+
+		//Both edges leaving v0 are cut halfway
+		EXPECT_EQ(polygon[0].uv, Vector2(0.f, 0.f));
+		EXPECT_FLOAT_EQ(polygon[1].uv.x, 0.5f);
+		EXPECT_FLOAT_EQ(polygon[1].uv.y, 0.f);
+		EXPECT_FLOAT_EQ(polygon[2].uv.x, 0.f);
+		EXPECT_FLOAT_EQ(polygon[2].uv.y, 0.5f);
+
+		ExpectInsideClipVolume(polygon, 3);
+	}
+
+	TEST(ClippingTest, CrossingNearAndFarPlaneGivesPentagon)
+	{
+		//v0 beyond the far plane, v2 beyond the near plane, each plane adds one vertex
+		Vertex_Out polygon[Renderer::MAX_CLIP_POLYGON_SIZE]
+		{
+			CreateVertex({ 0.f, 0.f, -0.5f, 1.f }, { 0.f, 0.f }, colors::Red),
+			CreateVertex({ 1.f, 0.f, 0.5f, 1.f }, { 1.f, 0.f }, colors::Green),
+			CreateVertex({ 0.f, 1.f, 1.5f, 1.f }, { 0.f, 1.f }, colors::Blue)
+		};
+
+		const int polygonSize{ Renderer::ClipPolygon(polygon, 3) };
+		ASSERT_EQ(polygonSize, 5);
+		ExpectInsideClipVolume(polygon, polygonSize);
+	}
+
+	TEST(ClippingTest, GuardBandClipsOnlyFarOffScreenVertices)
+	{
+		//x of v1 is twice the guard band, the edges towards it are cut halfway
+		Vertex_Out polygon[Renderer::MAX_CLIP_POLYGON_SIZE]
+		{
+			CreateVertex({ 0.f, 0.f, 0.5f, 1.f }, { 0.f, 0.f }, colors::Red),
+			CreateVertex({ 2.f * Renderer::GUARD_BAND, 0.f, 0.5f, 1.f }, { 1.f, 0.f }, colors::Green),
+			CreateVertex({ 0.f, 1.f, 0.5f, 1.f }, { 0.f, 1.f }, colors::Blue)
+		};
+
+		ASSERT_EQ(Renderer::ClipPolygon(polygon, 3), 4);
+		EXPECT_FLOAT_EQ(polygon[1].position.x, Renderer::GUARD_BAND);
+		EXPECT_FLOAT_EQ(polygon[1].uv.x, 0.5f);
+		EXPECT_FLOAT_EQ(polygon[2].position.x, Renderer::GUARD_BAND);
+		EXPECT_FLOAT_EQ(polygon[2].uv.x, 0.5f);
+		EXPECT_FLOAT_EQ(polygon[2].uv.y, 0.5f);
+		ExpectInsideClipVolume(polygon, 4);
+	}
+
+	TEST(ClippingTest, TriangleOutsideOnePlaneIsCulled)
+	{
+		Vertex_Out polygon[Renderer::MAX_CLIP_POLYGON_SIZE]
+		{
+			CreateVertex({ 0.f, 0.f, 2.f, 1.f }, { 0.f, 0.f }, colors::Red),
+			CreateVertex({ 1.f, 0.f, 2.f, 1.f }, { 1.f, 0.f }, colors::Green),
+			CreateVertex({ 0.f, 1.f, 2.f, 1.f }, { 0.f, 1.f }, colors::Blue)
+		};
+
+		EXPECT_EQ(Renderer::ClipPolygon(polygon, 3), 0);
+	}
+}
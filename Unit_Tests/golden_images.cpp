@@ -0,0 +1,296 @@
+#include "gtest/gtest.h"
+
+//Standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//External includes
+#include "SDL.h"
+#include "SDL_surface.h"
+
+//Project includes
+#include "Renderer.h"
+#include "RenderTarget.h"
+#include "Texture.h"
+#include "Timer.h"
+
+namespace dae
+{
+	namespace
+	{
+		//Small frames keep the suite fast, they still cover several tiles and partial tiles on the edges
+		constexpr int IMAGE_WIDTH{ 160 };
+		constexpr int IMAGE_HEIGHT{ 120 };
+
+		//Stored references may come from another compiler, rounding differs there
+		constexpr int REFERENCE_TOLERANCE{ 8 };
+		constexpr float REFERENCE_MAX_MISMATCH{ 0.002f };
+
+		//Every path shares the same shading code, they may only differ by rounding
+		//The scalar and SIMD edge functions only round the same when no multiply and add gets fused into an FMA,
+		//so every build turns contraction off (-ffp-contract=off, /fp:precise)
+		constexpr int PATH_TOLERANCE{ 2 };
+		constexpr float PATH_MAX_MISMATCH{ 0.f };
+
+		const std::filesystem::path g_TestDirectory{ std::filesystem::path(__FILE__).parent_path() };
+		const std::filesystem::path g_ResourceDirectory{ g_TestDirectory / ".." / "Rasterizer" / "Resources" };
+		const std::filesystem::path g_ReferenceDirectory{ g_TestDirectory / "References" };
+
+		enum class Scene
+		{
+			vehicle,
+			tuktuk
+		};
+
+		//How often CycleShadingMode is called, the renderer starts in combined
+		enum class ShadingMode
+		{
+			combined = 0,
+			overdraw = 1,
+			observedArea = 2,
+			diffuse = 3,
+			specular = 4
+		};
+
+		struct GoldenImageSetup
+		{
+			std::string name{};
+			Scene scene{};
+			ShadingMode shadingMode{};
+			float time{};
+			bool normalMappingOn{ true };
+			bool depthBufferOn{ false };
+			Texture::Filter textureFilter{ Texture::Filter::point };
+		};
+
+		struct RenderPath
+		{
+			std::string name{};
+			bool simdRasterizationOn{};
+			bool deferredShadingOn{};
+			Texture::Layout texelLayout{ Texture::Layout::linear };
+		};
+
+		struct ImageDifference
+		{
+			int maxError{};
+			float psnr{};
+			float mismatchFraction{};
+		};
+
+		Renderer::SceneDescription CreateScene(Scene scene)
+		{
+			const auto resource = [](const char* pFile)
+				{
+					return (g_ResourceDirectory / pFile).string();
+				};
+
+			Renderer::SceneDescription description{};
+			switch (scene)
+			{
+			case Scene::vehicle:
+				description.meshPath = resource("vehicle.obj");
+				description.diffuseTexturePath = resource("vehicle_diffuse.png");
+				description.normalTexturePath = resource("vehicle_normal.png");
+				description.glossTexturePath = resource("vehicle_gloss.png");
+				description.specularTexturePath = resource("vehicle_specular.png");
+				break;
+			case Scene::tuktuk:
+				//Only has a diffuse map, so it is drawn without anything that needs normals or specular
+				description.meshPath = resource("tuktuk.obj");
+				description.diffuseTexturePath = resource("tuktuk.png");
+				description.normalTexturePath.clear();
+				description.glossTexturePath.clear();
+				description.specularTexturePath.clear();
+				description.meshPosition = { 0.f, -5.5f, -48.f };
+				break;
+			}
+
+			return description;
+		}
+
+		//Renders a single frame of the setup at its time, the result stays in the render target
+		void RenderFrame(const GoldenImageSetup& setup, const RenderPath& path, RenderTarget& renderTarget)
+		{
+			Renderer::SceneDescription scene{ CreateScene(setup.scene) };
+			scene.texelLayout = path.texelLayout;
+			ASSERT_TRUE(std::filesystem::exists(scene.meshPath)) << "Could not find " << scene.meshPath;
+
+			Renderer renderer{ &renderTarget, scene };
+
+			for (int cycle{}; cycle < static_cast<int>(setup.shadingMode); ++cycle)
+			{
+				renderer.CycleShadingMode();
+			}
+			if (!setup.normalMappingOn)
+				renderer.ToggleNormalMapping();
+			if (setup.depthBufferOn)
+				renderer.ToggleDepthBuffer();
+			for (int cycle{}; cycle < static_cast<int>(setup.textureFilter); ++cycle)
+			{
+				renderer.CycleTextureFilter();
+			}
+			if (!path.simdRasterizationOn)
+				renderer.ToggleSIMDRasterization();
+			if (path.deferredShadingOn)
+				renderer.ToggleDeferredShading();
+
+			//One fixed step straight to the time of the setup, independent of how fast the machine is
+			//A time of 0 is a step of 0, the frame at the start
+			Timer timer{};
+			timer.SetFixedElapsed(setup.time);
+			timer.Start();
+			timer.Update();
+
+			renderer.Update(&timer);
+			renderer.Render();
+		}
+
+		//Per channel comparison of two surfaces in the same 32 bit format
+		ImageDifference CompareImages(SDL_Surface* pImage, SDL_Surface* pReference, int tolerance)
+		{
+			ImageDifference difference{};
+
+			const int pixelCount{ pImage->w * pImage->h };
+			double squaredErrorSum{};
+			int mismatchCount{};
+
+			for (int py{}; py < pImage->h; ++py)
+			{
+				for (int px{}; px < pImage->w; ++px)
+				{
+					const uint32_t pixel{ static_cast<const uint32_t*>(pImage->pixels)[py * pImage->pitch / 4 + px] };
+					const uint32_t referencePixel{ static_cast<const uint32_t*>(pReference->pixels)[py * pReference->pitch / 4 + px] };
+
+					Uint8 color[3]{};
+					Uint8 referenceColor[3]{};
+					SDL_GetRGB(pixel, pImage->format, &color[0], &color[1], &color[2]);
+					SDL_GetRGB(referencePixel, pReference->format, &referenceColor[0], &referenceColor[1], &referenceColor[2]);
+
+					int pixelError{};
+					for (int channel{}; channel < 3; ++channel)
+					{
+						const int error{ std::abs(static_cast<int>(color[channel]) - static_cast<int>(referenceColor[channel])) };
+						pixelError = std::max(pixelError, error);
+						squaredErrorSum += static_cast<double>(error * error);
+					}
+
+					difference.maxError = std::max(difference.maxError, pixelError);
+					if (pixelError > tolerance)
+						++mismatchCount;
+				}
+			}
+
+			const double meanSquaredError{ squaredErrorSum / (3.0 * pixelCount) };
+			difference.psnr = (meanSquaredError > 0.0) ? static_cast<float>(10.0 * std::log10(255.0 * 255.0 / meanSquaredError)) : INFINITY;
+			difference.mismatchFraction = static_cast<float>(mismatchCount) / static_cast<float>(pixelCount);
+
+			return difference;
+		}
+
+		void ExpectImagesMatch(SDL_Surface* pImage, SDL_Surface* pReference, int tolerance, float maxMismatch, const std::string& description)
+		{
+			ASSERT_EQ(pImage->w, pReference->w) << description;
+			ASSERT_EQ(pImage->h, pReference->h) << description;
+
+			//References load as 24 bit BMPs, the render targets are 32 bit, so both are converted to one format
+			SDL_Surface* pConvertedImage{ SDL_ConvertSurfaceFormat(pImage, SDL_PIXELFORMAT_ARGB8888, 0) };
+			SDL_Surface* pConvertedReference{ SDL_ConvertSurfaceFormat(pReference, SDL_PIXELFORMAT_ARGB8888, 0) };
+			ASSERT_NE(pConvertedImage, nullptr) << description << ": " << SDL_GetError();
+			ASSERT_NE(pConvertedReference, nullptr) << description << ": " << SDL_GetError();
+
+			const ImageDifference difference{ CompareImages(pConvertedImage, pConvertedReference, tolerance) };
+			SDL_FreeSurface(pConvertedImage);
+			SDL_FreeSurface(pConvertedReference);
+			std::cout << description << ": PSNR " << difference.psnr << " dB, max error " << difference.maxError
+				<< ", " << difference.mismatchFraction * 100.f << "% over tolerance" << std::endl;
+
+			EXPECT_LE(difference.mismatchFraction, maxMismatch)
+				<< description << ": max error " << difference.maxError << ", PSNR " << difference.psnr << " dB";
+		}
+
+		const std::vector<GoldenImageSetup> g_Setups
+		{
+			{ "vehicle_combined_0", Scene::vehicle, ShadingMode::combined, 0.f },
+			{ "vehicle_combined_2_7", Scene::vehicle, ShadingMode::combined, 2.7f },
+			{ "vehicle_flat_combined_5_1", Scene::vehicle, ShadingMode::combined, 5.1f, false },
+			{ "vehicle_diffuse_9", Scene::vehicle, ShadingMode::diffuse, 9.f },
+			{ "vehicle_depth_1_3", Scene::vehicle, ShadingMode::combined, 1.3f, true, true },
+			{ "tuktuk_diffuse_0", Scene::tuktuk, ShadingMode::diffuse, 0.f, false },
+			{ "tuktuk_observed_area_1_5", Scene::tuktuk, ShadingMode::observedArea, 1.5f, false },
+			{ "vehicle_bilinear_combined_0", Scene::vehicle, ShadingMode::combined, 0.f, true, false, Texture::Filter::bilinear },
+			{ "vehicle_nearest_mip_diffuse_9", Scene::vehicle, ShadingMode::diffuse, 9.f, true, false, Texture::Filter::nearestMip },
+			{ "vehicle_trilinear_combined_2_7", Scene::vehicle, ShadingMode::combined, 2.7f, true, false, Texture::Filter::trilinear },
+			{ "tuktuk_trilinear_diffuse_0", Scene::tuktuk, ShadingMode::diffuse, 0.f, false, false, Texture::Filter::trilinear },
+		};
+
+		//The scalar forward path is the reference every other path is checked against
+		const RenderPath g_ScalarForward{ "scalar forward", false, false };
+		const std::vector<RenderPath> g_AlternativePaths
+		{
+			{ "SIMD forward", true, false },
+			{ "scalar deferred", false, true },
+			{ "SIMD deferred", true, true },
+			{ "SIMD forward, tiled texels", true, false, Texture::Layout::tiled },
+			{ "SIMD forward, morton texels", true, false, Texture::Layout::morton },
+		};
+	}
+
+	class GoldenImageTest : public testing::TestWithParam<GoldenImageSetup>
+	{
+	};
+
+	//Set UPDATE_GOLDEN_IMAGES to write the scalar forward output as the new references
+	TEST_P(GoldenImageTest, MatchesReference)
+	{
+		const GoldenImageSetup& setup{ GetParam() };
+
+		RenderTarget renderTarget{ IMAGE_WIDTH, IMAGE_HEIGHT };
+		ASSERT_NO_FATAL_FAILURE(RenderFrame(setup, g_ScalarForward, renderTarget));
+
+		const std::string referencePath{ (g_ReferenceDirectory / (setup.name + ".bmp")).string() };
+		if (std::getenv("UPDATE_GOLDEN_IMAGES"))
+		{
+			std::filesystem::create_directories(g_ReferenceDirectory);
+			ASSERT_TRUE(renderTarget.SaveColorBuffer(referencePath)) << "Could not write " << referencePath;
+			std::cout << "Reference " << referencePath << " written" << std::endl;
+			return;
+		}
+
+		ASSERT_TRUE(std::filesystem::exists(referencePath)) << "Missing reference " << referencePath << ", set UPDATE_GOLDEN_IMAGES to write it";
+
+		SDL_Surface* pReference{ SDL_LoadBMP(referencePath.c_str()) };
+		ASSERT_NE(pReference, nullptr) << "Could not read " << referencePath;
+
+		ExpectImagesMatch(renderTarget.GetColorBuffer(), pReference, REFERENCE_TOLERANCE, REFERENCE_MAX_MISMATCH, setup.name + " vs reference");
+
+		SDL_FreeSurface(pReference);
+	}
+
+	TEST_P(GoldenImageTest, PathsMatchScalarForward)
+	{
+		const GoldenImageSetup& setup{ GetParam() };
+
+		RenderTarget scalarTarget{ IMAGE_WIDTH, IMAGE_HEIGHT };
+		ASSERT_NO_FATAL_FAILURE(RenderFrame(setup, g_ScalarForward, scalarTarget));
+
+		for (const RenderPath& path : g_AlternativePaths)
+		{
+			RenderTarget renderTarget{ IMAGE_WIDTH, IMAGE_HEIGHT };
+			ASSERT_NO_FATAL_FAILURE(RenderFrame(setup, path, renderTarget));
+
+			ExpectImagesMatch(renderTarget.GetColorBuffer(), scalarTarget.GetColorBuffer(), PATH_TOLERANCE, PATH_MAX_MISMATCH, setup.name + " " + path.name);
+		}
+	}
+
+	INSTANTIATE_TEST_CASE_P(Scenes, GoldenImageTest, testing::ValuesIn(g_Setups),
+		[](const testing::TestParamInfo<GoldenImageSetup>& info)
+		{
+			return info.param.name;
+		});
+}
@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+
+//Standard includes
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+//Project includes
+#include "DataTypes.h"
+#include "Utils.h"
+
+namespace dae
+{
+	namespace
+	{
+		using IndexTriple = std::array<uint32_t, 3>;
+
+		//A grid of quadsPerSide x quadsPerSide quads, two triangles each, in a shuffled order so there is locality to win back
+		void CreateShuffledGrid(int quadsPerSide, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			const int verticesPerSide{ quadsPerSide + 1 };
+			for (int y{}; y < verticesPerSide; ++y)
+			{
+				for (int x{}; x < verticesPerSide; ++x)
+				{
+					Vertex vertex{};
+					vertex.position = { static_cast<float>(x), static_cast<float>(y), 0.f };
+					vertex.uv = { static_cast<float>(x) / quadsPerSide, static_cast<float>(y) / quadsPerSide };
+					vertices.push_back(vertex);
+				}
+			}
+
+			std::vector<IndexTriple> triangles{};
+			for (int y{}; y < quadsPerSide; ++y)
+			{
+				for (int x{}; x < quadsPerSide; ++x)
+				{
+					const uint32_t topLeft{ static_cast<uint32_t>(y * verticesPerSide + x) };
+					const uint32_t bottomLeft{ topLeft + static_cast<uint32_t>(verticesPerSide) };
+					triangles.push_back({ topLeft, bottomLeft, topLeft + 1 });
+					triangles.push_back({ topLeft + 1, bottomLeft, bottomLeft + 1 });
+				}
+			}
+
+			std::mt19937 generator{ 0 };
+			std::shuffle(triangles.begin(), triangles.end(), generator);
+			for (const IndexTriple& triangle : triangles)
+			{
+				indices.insert(indices.end(), triangle.begin(), triangle.end());
+			}
+		}
+
+		//Every triangle rotated so its smallest index comes first, which keeps the winding, then sorted
+		std::vector<IndexTriple> GetSortedTriangles(const std::vector<uint32_t>& indices)
+		{
+			std::vector<IndexTriple> triangles{};
+			for (size_t index{}; index + 2 < indices.size(); index += 3)
+			{
+				IndexTriple triangle{ indices[index], indices[index + 1], indices[index + 2] };
+				std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+				triangles.push_back(triangle);
+			}
+
+			std::sort(triangles.begin(), triangles.end());
+			return triangles;
+		}
+	}
+
+	TEST(MeshOptimizationTest, ACMRCountsFIFOMisses)
+	{
+		//Too few indices for a triangle
+		EXPECT_EQ(Utils::CalculateACMR({ 0, 1 }, 2), 0.f);
+
+		//Every vertex of a lone triangle is a miss
+		EXPECT_EQ(Utils::CalculateACMR({ 0, 1, 2 }, 3), 3.f);
+
+		//The second triangle reuses two cached vertices: 4 misses over 2 triangles
+		EXPECT_EQ(Utils::CalculateACMR({ 0, 1, 2, 2, 1, 3 }, 4), 2.f);
+
+		//A fan with a 3 entry cache: misses 0 1 2, hits 0 2, miss 3, then 0 was loaded 3 misses ago and is evicted,
+		//miss 0, hit 3, miss 4, 6 misses over 3 triangles
+		EXPECT_EQ(Utils::CalculateACMR({ 0, 1, 2, 0, 2, 3, 0, 3, 4 }, 5, 3), 2.f);
+	}
+
+	TEST(MeshOptimizationTest, VertexCacheKeepsEveryTriangle)
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		CreateShuffledGrid(16, vertices, indices);
+
+		const std::vector<IndexTriple> trianglesBefore{ GetSortedTriangles(indices) };
+		const float acmrBefore{ Utils::CalculateACMR(indices, vertices.size()) };
+
+		Utils::OptimizeVertexCache(indices, vertices.size());
+
+		ASSERT_EQ(indices.size(), trianglesBefore.size() * 3);
+		EXPECT_EQ(GetSortedTriangles(indices), trianglesBefore);
+		EXPECT_LT(Utils::CalculateACMR(indices, vertices.size()), acmrBefore);
+	}
+
+	TEST(MeshOptimizationTest, VertexFetchKeepsEveryTrianglePosition)
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		CreateShuffledGrid(8, vertices, indices);
+
+		//One vertex no triangle uses, it gets dropped
+		vertices.push_back(Vertex{ Vector3{ -1.f, -1.f, -1.f } });
+
+		const std::vector<Vertex> verticesBefore{ vertices };
+		const std::vector<uint32_t> indicesBefore{ indices };
+
+		Utils::OptimizeVertexFetch(vertices, indices);
+
+		ASSERT_EQ(indices.size(), indicesBefore.size());
+		EXPECT_EQ(vertices.size(), verticesBefore.size() - 1);
+
+		uint32_t nextNewVertex{};
+		for (size_t index{}; index < indices.size(); ++index)
+		{
+			ASSERT_LT(indices[index], vertices.size());
+			EXPECT_EQ(vertices[indices[index]].position, verticesBefore[indicesBefore[index]].position) << "index " << index;
+			EXPECT_EQ(vertices[indices[index]].uv, verticesBefore[indicesBefore[index]].uv) << "index " << index;
+
+			//Vertices are numbered in the order the indices first use them
+			ASSERT_LE(indices[index], nextNewVertex) << "index " << index;
+			if (indices[index] == nextNewVertex)
+				++nextNewVertex;
+		}
+		EXPECT_EQ(nextNewVertex, vertices.size());
+	}
+}
@@ -0,0 +1,170 @@
+#include "gtest/gtest.h"
+
+//Standard includes
+#include <cmath>
+#include <utility>
+#include <vector>
+
+//Project includes
+#include "DataTypes.h"
+#include "PrimitiveAssembler.h"
+
+namespace dae
+{
+	namespace
+	{
+		//Screen positions only, Submit reads nothing else
+		VertexStreams CreateStreams(const std::vector<Vector2>& positions)
+		{
+			VertexStreams streams{};
+			streams.Resize(positions.size());
+			for (size_t index{}; index < positions.size(); ++index)
+			{
+				streams.positionX[index] = positions[index].x;
+				streams.positionY[index] = positions[index].y;
+			}
+
+			return streams;
+		}
+
+		void SubmitAll(PrimitiveAssembler& assembler, const std::vector<uint32_t>& triangleIndices, const VertexStreams& streams)
+		{
+			for (size_t index{}; index + 2 < triangleIndices.size(); index += 3)
+			{
+				assembler.Submit(0, triangleIndices[index], triangleIndices[index + 1], triangleIndices[index + 2], streams);
+			}
+		}
+
+		//A strip zigzagging along x, v0 (0, 0), v1 (0, 1), v2 (1, 0), v3 (1, 1)...
+		//then restarted by repeating 3 and 4 (two indices each), which gives four triangles with no area
+		const std::vector<uint32_t> g_StripIndices{ 0, 1, 2, 3, 3, 4, 4, 5, 6 };
+		const std::vector<Vector2> g_StripPositions{ { 0.f, 0.f }, { 0.f, 1.f }, { 1.f, 0.f }, { 1.f, 1.f }, { 2.f, 0.f }, { 2.f, 1.f }, { 3.f, 0.f } };
+	}
+
+	TEST(PrimitiveAssemblerTest, StripSwapsOddWindingAndSkipsRestarts)
+	{
+		Mesh mesh{};
+		mesh.primitiveTopology = PrimitiveTopology::TriangleStrip;
+		mesh.indices = g_StripIndices;
+
+		PrimitiveAssembler assembler{};
+		std::vector<uint32_t> triangleIndices{};
+		assembler.ResolveTopology(mesh, triangleIndices);
+
+		//Strip triangles 0 and 6 are even, 1 is odd and gets its last two vertices swapped, 2 to 5 repeat an index
+		const std::vector<uint32_t> expected{ 0, 1, 2, 1, 3, 2, 4, 5, 6 };
+		EXPECT_EQ(triangleIndices, expected);
+		EXPECT_EQ(assembler.GetTrianglesSubmitted(), 7u);
+		EXPECT_EQ(assembler.GetTrianglesCulled(PrimitiveAssembler::CullReason::degenerate), 4u);
+		EXPECT_EQ(assembler.GetTrianglesCulled(PrimitiveAssembler::CullReason::facing), 0u);
+	}
+
+	TEST(PrimitiveAssemblerTest, StripTrianglesShareOneWinding)
+	{
+		Mesh mesh{};
+		mesh.primitiveTopology = PrimitiveTopology::TriangleStrip;
+		mesh.indices = g_StripIndices;
+		const VertexStreams streams{ CreateStreams(g_StripPositions) };
+
+		PrimitiveAssembler assembler{};
+		std::vector<uint32_t> triangleIndices{};
+		assembler.ResolveTopology(mesh, triangleIndices);
+		SubmitAll(assembler, triangleIndices, streams);
+
+		//Every resolved triangle turns the same way on screen, counterclockwise here
+		const std::vector<Triangle>& triangles{ assembler.GetTriangles() };
+		ASSERT_EQ(triangles.size(), 3u);
+		for (const Triangle& triangle : triangles)
+		{
+			EXPECT_EQ(triangle.doubleArea, -1.f) << triangle.vertex0 << " " << triangle.vertex1 << " " << triangle.vertex2;
+		}
+
+		//Back face culling removes the whole strip, front face culling none of it
+		for (const auto& [cycles, expectedFacingCulled] : { std::pair{ 1, 3u }, std::pair{ 2, 0u } })
+		{
+			PrimitiveAssembler culling{};
+			for (int cycle{}; cycle < cycles; ++cycle)
+			{
+				culling.CycleCullMode();
+			}
+
+			culling.ResolveTopology(mesh, triangleIndices);
+			SubmitAll(culling, triangleIndices, streams);
+
+			EXPECT_EQ(culling.GetTrianglesCulled(PrimitiveAssembler::CullReason::facing), expectedFacingCulled) << "cull mode cycled " << cycles;
+			EXPECT_EQ(culling.GetTriangles().size(), 3u - expectedFacingCulled) << "cull mode cycled " << cycles;
+		}
+	}
+
+	TEST(PrimitiveAssemblerTest, ListSkipsTrianglesWithAnyTwoIndicesEqual)
+	{
+		Mesh mesh{};
+		mesh.primitiveTopology = PrimitiveTopology::TriangleList;
+
+		//v0 == v2, v0 == v1, v1 == v2, then one whole triangle, the two trailing indices make no triangle
+		mesh.indices = { 3, 4, 3, 5, 5, 6, 7, 8, 8, 0, 1, 2, 9, 10 };
+
+		PrimitiveAssembler assembler{};
+		std::vector<uint32_t> triangleIndices{};
+		assembler.ResolveTopology(mesh, triangleIndices);
+
+		const std::vector<uint32_t> expected{ 0, 1, 2 };
+		EXPECT_EQ(triangleIndices, expected);
+		EXPECT_EQ(assembler.GetTrianglesSubmitted(), 4u);
+		EXPECT_EQ(assembler.GetTrianglesCulled(PrimitiveAssembler::CullReason::degenerate), 3u);
+	}
+
+	TEST(PrimitiveAssemblerTest, SubmitCullsZeroAndNaNArea)
+	{
+		const VertexStreams streams{ CreateStreams({ { 0.f, 0.f }, { 1.f, 1.f }, { 2.f, 2.f }, { NAN, 0.f }, { 0.f, 1.f } }) };
+
+		PrimitiveAssembler assembler{};
+		assembler.Submit(0, 0, 1, 2, streams);
+		assembler.Submit(0, 0, 3, 4, streams);
+		assembler.Submit(0, 0, 4, 1, streams);
+
+		EXPECT_EQ(assembler.GetTrianglesCulled(PrimitiveAssembler::CullReason::degenerate), 2u);
+		ASSERT_EQ(assembler.GetTriangles().size(), 1u);
+		EXPECT_EQ(assembler.GetTriangles()[0].vertex1, 4u);
+
+		//Clear starts the next frame from zero
+		assembler.Clear();
+		EXPECT_EQ(assembler.GetTrianglesCulled(PrimitiveAssembler::CullReason::degenerate), 0u);
+		EXPECT_TRUE(assembler.GetTriangles().empty());
+		EXPECT_TRUE(assembler.GetBatches().empty());
+	}
+
+	TEST(PrimitiveAssemblerTest, BatchesSplitAtBatchSize)
+	{
+		const VertexStreams streams{ CreateStreams({ { 0.f, 0.f }, { 0.f, 1.f }, { 1.f, 0.f }, { 2.f, 2.f } }) };
+
+		//Every fourth submission has no area, culled triangles leave no gap in the batches
+		constexpr uint32_t submittedCount{ 4 * PrimitiveAssembler::BATCH_SIZE };
+		PrimitiveAssembler assembler{};
+		for (uint32_t submission{}; submission < submittedCount; ++submission)
+		{
+			if (submission % 4 == 3)
+				assembler.Submit(0, 0, 0, 3, streams);
+			else
+				assembler.Submit(0, 0, 1, 2, streams);
+		}
+
+		const uint32_t keptCount{ submittedCount - submittedCount / 4 };
+		ASSERT_EQ(assembler.GetTriangles().size(), keptCount);
+
+		//768 kept triangles, three full batches
+		const std::vector<PrimitiveAssembler::TriangleBatch>& batches{ assembler.GetBatches() };
+		ASSERT_EQ(batches.size(), 3u);
+		for (uint32_t batch{}; batch < batches.size(); ++batch)
+		{
+			EXPECT_EQ(batches[batch].firstTriangle, batch * PrimitiveAssembler::BATCH_SIZE) << "batch " << batch;
+			EXPECT_EQ(batches[batch].triangleCount, PrimitiveAssembler::BATCH_SIZE) << "batch " << batch;
+		}
+
+		//One more starts a fourth batch
+		assembler.Submit(0, 0, 1, 2, streams);
+		ASSERT_EQ(batches.size(), 4u);
+		EXPECT_EQ(batches[3].firstTriangle, keptCount);
+		EXPECT_EQ(batches[3].triangleCount, 1u);
+	}
+}
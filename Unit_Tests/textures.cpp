@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+//Standard includes
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+//Project includes
+#include "ColorRGB.h"
+#include "Texture.h"
+#include "Vector2.h"
+
+namespace dae
+{
+	namespace
+	{
+		const std::filesystem::path g_TexturePath
+		{
+			std::filesystem::path(__FILE__).parent_path() / ".." / "Rasterizer" / "Resources" / "vehicle_diffuse.png"
+		};
+
+		const char* const g_LayoutNames[]{ "linear", "tiled", "morton" };
+
+		//Random uvs plus the corners and edges, where the four texels get clamped
+		void CreateUVs(int count, std::vector<float>& u, std::vector<float>& v)
+		{
+			const float edges[]{ 0.f, 1.f, 0.5f / 2048.f, 1.f - 0.5f / 2048.f };
+			for (const float edgeU : edges)
+			{
+				for (const float edgeV : edges)
+				{
+					u.push_back(edgeU);
+					v.push_back(edgeV);
+				}
+			}
+
+			std::mt19937 generator{ 0 };
+			std::uniform_real_distribution<float> coordinate{ 0.f, 1.f };
+			while (static_cast<int>(u.size()) < count)
+			{
+				u.push_back(coordinate(generator));
+				v.push_back(coordinate(generator));
+			}
+		}
+	}
+
+	class TextureTest : public testing::TestWithParam<Texture::Layout>
+	{
+	};
+
+	//A count that is no multiple of eight also runs the remainder
+	TEST_P(TextureTest, BatchedBilinearMatchesSingleSamples)
+	{
+		const Texture* pTexture{ Texture::LoadFromFile(g_TexturePath.string(), GetParam()) };
+		ASSERT_NE(pTexture, nullptr) << "Could not load " << g_TexturePath;
+
+		constexpr int sampleCount{ 1000 + 5 };
+		std::vector<float> u{};
+		std::vector<float> v{};
+		CreateUVs(sampleCount, u, v);
+
+		std::vector<ColorRGB> colors(sampleCount);
+		pTexture->SampleBilinear(u.data(), v.data(), sampleCount, colors.data());
+
+		for (int index{}; index < sampleCount; ++index)
+		{
+			const ColorRGB expected{ pTexture->Sample({ u[index], v[index] }, {}, {}, Texture::Filter::bilinear) };
+			ASSERT_EQ(colors[index].r, expected.r) << "uv " << u[index] << ", " << v[index];
+			ASSERT_EQ(colors[index].g, expected.g) << "uv " << u[index] << ", " << v[index];
+			ASSERT_EQ(colors[index].b, expected.b) << "uv " << u[index] << ", " << v[index];
+		}
+
+		delete pTexture;
+	}
+
+	//On a texel center the blend weights are zero, only that texel is read
+	TEST_P(TextureTest, BilinearAtTexelCentersMatchesPoint)
+	{
+		const Texture* pTexture{ Texture::LoadFromFile(g_TexturePath.string(), GetParam()) };
+		ASSERT_NE(pTexture, nullptr) << "Could not load " << g_TexturePath;
+
+		const int width{ pTexture->GetWidth() };
+		const int height{ pTexture->GetHeight() };
+		for (int texel{}; texel < 256; ++texel)
+		{
+			const int x{ (texel * 7) % width };
+			const int y{ (texel * 5) % height };
+			const Vector2 uv{ (x + 0.5f) / width, (y + 0.5f) / height };
+			const ColorRGB point{ pTexture->Sample(uv) };
+			const ColorRGB bilinear{ pTexture->Sample(uv, {}, {}, Texture::Filter::bilinear) };
+			ASSERT_EQ(bilinear.r, point.r) << "uv " << uv.x << ", " << uv.y;
+			ASSERT_EQ(bilinear.g, point.g) << "uv " << uv.x << ", " << uv.y;
+			ASSERT_EQ(bilinear.b, point.b) << "uv " << uv.x << ", " << uv.y;
+		}
+
+		delete pTexture;
+	}
+
+	//The stand-in for a missing texture, every filter reads its one texel
+	TEST_P(TextureTest, ColorTextureSamplesItsColor)
+	{
+		const Texture* pTexture{ Texture::CreateFromColor({ 0.5f, 0.5f, 1.f }, GetParam()) };
+		ASSERT_NE(pTexture, nullptr);
+		ASSERT_EQ(pTexture->GetWidth(), 1);
+		ASSERT_EQ(pTexture->GetHeight(), 1);
+
+		const Vector2 derivative{ 4.f, 4.f };
+		for (const Vector2& uv : { Vector2{ 0.f, 0.f }, Vector2{ 0.3f, 0.8f }, Vector2{ 1.f, 1.f } })
+		{
+			for (int filter{}; filter < static_cast<int>(Texture::Filter::number); ++filter)
+			{
+				const ColorRGB color{ pTexture->Sample(uv, derivative, derivative, static_cast<Texture::Filter>(filter)) };
+				ASSERT_EQ(color.r, 128.f / 255.f) << "filter " << filter;
+				ASSERT_EQ(color.g, 128.f / 255.f) << "filter " << filter;
+				ASSERT_EQ(color.b, 1.f) << "filter " << filter;
+			}
+		}
+
+		delete pTexture;
+	}
+
+	INSTANTIATE_TEST_CASE_P(Layouts, TextureTest, testing::Values(Texture::Layout::linear, Texture::Layout::tiled, Texture::Layout::morton),
+		[](const testing::TestParamInfo<Texture::Layout>& info)
+		{
+			return std::string{ g_LayoutNames[static_cast<int>(info.param)] };
+		});
+}